@@ -0,0 +1,354 @@
+#ifndef SJTU_ALLOCATOR_HPP
+#define SJTU_ALLOCATOR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+namespace sjtu {
+
+    /**
+     * the default node/block allocation policy: global operator new/delete.
+     */
+    struct heap_allocator {
+        static void *allocate(size_t n) {
+            return ::operator new(n);
+        }
+
+        static void deallocate(void *p, size_t) noexcept {
+            ::operator delete(p);
+        }
+    };
+
+    /**
+     * carves small objects out of 2 MiB arenas.
+     * every thread owns its own arena and per-size free lists, so allocation
+     * only locks when a list and the arena both run out, and pages are first
+     * touched (hence placed on the NUMA node of) the thread that builds the
+     * deque. arenas are 2 MiB aligned and marked MADV_HUGEPAGE on Linux, so a
+     * block chain spans few TLB entries.
+     * a freed object goes to the free list of the thread that frees it; once
+     * a thread has freed keep_bytes of one size since it last drew from the
+     * shared pool, its whole list for that size moves to the pool, so memory
+     * freed by a consumer thread flows back to the producer. threads draw
+     * from the pool keep_bytes at a time, in preference to carving. an
+     * exiting thread hands its lists and the unused rest of its arena to the
+     * pool as well.
+     * arenas are kept for the lifetime of the process.
+     * an object is aligned to the largest power of two dividing its size (at
+     * most 4096), which covers alignof of any type of that size.
+     * requests larger than max_size are allocated on their own.
+     */
+    class arena_allocator {
+        static const size_t arena_size = (size_t) 2 << 20;
+        static const size_t grain = 16;
+        static const size_t max_size = 4096;
+        static const size_t classes = max_size / grain + 1;
+        static const size_t keep_bytes = (size_t) 256 << 10;
+
+        struct free_node {
+            free_node *nex;
+        };
+
+        struct free_list {
+            free_node *head;
+            free_node *tail;
+
+            free_list() : head(nullptr), tail(nullptr) {}
+
+            void push(free_node *p) {
+                p->nex = head;
+                if (head == nullptr)
+                    tail = p;
+                head = p;
+            }
+
+            free_node *pop() {
+                free_node *p = head;
+                head = p->nex;
+                if (head == nullptr)
+                    tail = nullptr;
+                return p;
+            }
+
+            /**
+             * move up to n nodes from the front of o to this list.
+             */
+            void take(free_list &o, size_t n) {
+                if (o.head == nullptr || n == 0)
+                    return;
+                free_node *last = o.head;
+                for (size_t i = 1; i < n && last->nex != nullptr; ++i)
+                    last = last->nex;
+                free_list part;
+                part.head = o.head;
+                part.tail = last;
+                o.head = last->nex;
+                if (o.head == nullptr)
+                    o.tail = nullptr;
+                last->nex = nullptr;
+                splice(part);
+            }
+
+            /**
+             * move all of o to the front of this list in O(1).
+             */
+            void splice(free_list &o) {
+                if (o.head == nullptr)
+                    return;
+                o.tail->nex = head;
+                if (head == nullptr)
+                    tail = o.tail;
+                head = o.head;
+                o.head = o.tail = nullptr;
+            }
+        };
+
+        /**
+         * the unused rest [this, end) of an arena, given back by a thread.
+         */
+        struct chunk {
+            char *end;
+            chunk *nex;
+        };
+
+        /**
+         * ready[k] mirrors list[k].head != nullptr, so a thread can see that
+         * the pool has objects of a size without taking the lock.
+         */
+        struct pool {
+            std::mutex lock;
+            free_list list[classes];
+            std::atomic<bool> ready[classes];
+            chunk *rest;
+
+            pool() : rest(nullptr) {
+                for (size_t i = 0; i < classes; ++i)
+                    ready[i].store(false, std::memory_order_relaxed);
+            }
+
+            void mark(size_t k) {
+                ready[k].store(list[k].head != nullptr, std::memory_order_relaxed);
+            }
+        };
+
+        struct cache {
+            free_list list[classes];
+            size_t freed[classes];
+            char *cur;
+            char *end;
+
+            cache() : cur(nullptr), end(nullptr) {
+                for (size_t i = 0; i < classes; ++i)
+                    freed[i] = 0;
+            }
+
+            ~cache() {
+                dead() = true;
+                pool &g = shared();
+                std::lock_guard<std::mutex> guard(g.lock);
+                for (size_t i = 0; i < classes; ++i) {
+                    g.list[i].splice(list[i]);
+                    g.mark(i);
+                }
+                give_back(g, cur, end);
+            }
+        };
+
+        static pool &shared() {
+            static pool *g = new pool;
+            return *g;
+        }
+
+        static bool &dead() {
+            thread_local bool v = false;
+            return v;
+        }
+
+        /**
+         * nullptr once the calling thread's cache has been destroyed, e.g. for
+         * deques with static storage freed after thread_local destructors ran.
+         */
+        static cache *local() {
+            if (dead())
+                return nullptr;
+            thread_local cache c;
+            return &c;
+        }
+
+        static size_t align_of(size_t bytes) {
+            size_t a = bytes & (~bytes + 1);
+            return a < max_size ? a : max_size;
+        }
+
+        static char *align_up(char *p, size_t a) {
+            return reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(p) + a - 1) & ~(uintptr_t) (a - 1));
+        }
+
+        static void *raw_allocate(size_t n, size_t a) {
+#if defined(_WIN32)
+            void *p = _aligned_malloc(n, a);
+            if (p == nullptr)
+                throw std::bad_alloc();
+            return p;
+#elif defined(__unix__) || defined(__APPLE__)
+            void *p = nullptr;
+            if (posix_memalign(&p, a < sizeof(void *) ? sizeof(void *) : a, n) != 0)
+                throw std::bad_alloc();
+            return p;
+#else
+            char *raw = static_cast<char *>(::operator new(n + a + sizeof(void *)));
+            char *p = align_up(raw + sizeof(void *), a);
+            reinterpret_cast<void **>(p)[-1] = raw;
+            return p;
+#endif
+        }
+
+        static void raw_deallocate(void *p) noexcept {
+#if defined(_WIN32)
+            _aligned_free(p);
+#elif defined(__unix__) || defined(__APPLE__)
+            free(p);
+#else
+            ::operator delete(reinterpret_cast<void **>(p)[-1]);
+#endif
+        }
+
+        /**
+         * keep [cur, end) in the shared pool if it can still hold an aligned
+         * max_size object; the caller holds the pool lock.
+         */
+        static void give_back(pool &g, char *cur, char *end) {
+            if (cur == nullptr || (size_t) (end - cur) < 2 * max_size)
+                return;
+            chunk *c = reinterpret_cast<chunk *>(cur);
+            c->end = end;
+            c->nex = g.rest;
+            g.rest = c;
+        }
+
+        static void take_shared(cache &c, size_t k) {
+            pool &g = shared();
+            std::lock_guard<std::mutex> guard(g.lock);
+            c.list[k].take(g.list[k], keep_bytes / (k * grain));
+            g.mark(k);
+            c.freed[k] = 0;
+        }
+
+        static void new_arena(cache &c) {
+            {
+                pool &g = shared();
+                std::lock_guard<std::mutex> guard(g.lock);
+                if (g.rest != nullptr) {
+                    chunk *r = g.rest;
+                    g.rest = r->nex;
+                    c.cur = reinterpret_cast<char *>(r);
+                    c.end = r->end;
+                    return;
+                }
+            }
+            void *p = raw_allocate(arena_size, arena_size);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+            if (huge_pages())
+                madvise(p, arena_size, MADV_HUGEPAGE);
+#endif
+            c.cur = static_cast<char *>(p);
+            c.end = c.cur + arena_size;
+            if (prefault()) {
+                for (char *q = c.cur; q < c.end; q += 4096)
+                    *q = 0;
+            }
+        }
+
+        static bool fits(const cache &c, size_t bytes, size_t a) {
+            return c.cur != nullptr && align_up(c.cur, a) + bytes <= c.end;
+        }
+
+    public:
+        /**
+         * ask for transparent huge pages on new arenas (default on).
+         */
+        static bool &huge_pages() {
+            static bool v = true;
+            return v;
+        }
+
+        /**
+         * touch every page of a new arena right away, so it is placed on the
+         * allocating thread's NUMA node before anything else uses it.
+         */
+        static bool &prefault() {
+            static bool v = false;
+            return v;
+        }
+
+        static void *allocate(size_t n) {
+            if (n > max_size)
+                return raw_allocate(n, align_of(n));
+            size_t k = n == 0 ? 1 : (n + grain - 1) / grain;
+            size_t bytes = k * grain;
+            size_t a = align_of(bytes);
+            cache *c = local();
+            if (c == nullptr) {
+                pool &g = shared();
+                std::lock_guard<std::mutex> guard(g.lock);
+                if (g.list[k].head == nullptr)
+                    return raw_allocate(bytes, a);
+                free_node *tmp = g.list[k].pop();
+                g.mark(k);
+                return tmp;
+            }
+            if (c->list[k].head == nullptr) {
+                bool room = fits(*c, bytes, a);
+                if (!room || shared().ready[k].load(std::memory_order_relaxed))
+                    take_shared(*c, k);
+                if (c->list[k].head == nullptr && !room)
+                    new_arena(*c);
+            }
+            if (c->list[k].head != nullptr)
+                return c->list[k].pop();
+            char *p = align_up(c->cur, a);
+            c->cur = p + bytes;
+            return p;
+        }
+
+        static void deallocate(void *p, size_t n) noexcept {
+            if (n > max_size) {
+                raw_deallocate(p);
+                return;
+            }
+            size_t k = n == 0 ? 1 : (n + grain - 1) / grain;
+            free_node *tmp = static_cast<free_node *>(p);
+            cache *c = local();
+            if (c == nullptr) {
+                pool &g = shared();
+                std::lock_guard<std::mutex> guard(g.lock);
+                g.list[k].push(tmp);
+                g.mark(k);
+                return;
+            }
+            c->list[k].push(tmp);
+            c->freed[k] += k * grain;
+            if (c->freed[k] >= keep_bytes) {
+                pool &g = shared();
+                std::lock_guard<std::mutex> guard(g.lock);
+                g.list[k].splice(c->list[k]);
+                g.mark(k);
+                c->freed[k] = 0;
+            }
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * sjtu::deque with heap_allocator against arena_allocator:
+ * - memory, measured first while the process is still small: resident set
+ *   growth when one thread builds deques and another frees them, and when
+ *   several short-lived threads each build and drop a deque (every thread
+ *   gets its own arena).
+ * - throughput of push_back, a full scan, random at() and pop_front. run
+ *   under `perf stat -e dTLB-load-misses,cache-misses` to see the TLB side.
+ * usage: bench_arena_allocator [elements = 4000000]
+ */
+#include "bench.hpp"
+#include "deque.hpp"
+
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+/**
+ * a /proc/self/status field in MiB, or -1 where there is no procfs.
+ */
+static long status_mib(const char *key) {
+    FILE *f = std::fopen("/proc/self/status", "r");
+    if (f == nullptr)
+        return -1;
+    char line[256];
+    long v = -1;
+    size_t len = std::strlen(key);
+    while (std::fgets(line, sizeof(line), f) != nullptr)
+        if (std::strncmp(line, key, len) == 0)
+            v = std::atol(line + len) / 1024;
+    std::fclose(f);
+    return v;
+}
+
+template<class A>
+void throughput(const char *name, size_t n) {
+    typedef sjtu::deque<long, A> deque;
+    char label[64];
+    deque d;
+    double t0 = bench::now_ms();
+    for (size_t i = 0; i < n; ++i)
+        d.push_back((long) i);
+    std::snprintf(label, sizeof(label), "%s push_back", name);
+    bench::report(label, n, bench::now_ms() - t0);
+
+    long sum = 0;
+    t0 = bench::now_ms();
+    for (typename deque::iterator x = d.begin(); x != d.end(); ++x)
+        sum += *x;
+    std::snprintf(label, sizeof(label), "%s scan", name);
+    bench::report(label, n, bench::now_ms() - t0);
+
+    size_t m = n / 1024, j = 1;
+    t0 = bench::now_ms();
+    for (size_t i = 0; i < m; ++i) {
+        j = (j * 2862933555777941757UL + 3037000493UL) % n;
+        sum += d[j];
+    }
+    std::snprintf(label, sizeof(label), "%s random at()", name);
+    bench::report(label, m, bench::now_ms() - t0);
+
+    t0 = bench::now_ms();
+    while (!d.empty())
+        d.pop_front();
+    std::snprintf(label, sizeof(label), "%s pop_front", name);
+    bench::report(label, n, bench::now_ms() - t0);
+    bench::keep(sum);
+}
+
+template<class A>
+void producer_consumer(const char *name) {
+    typedef sjtu::deque<int, A> deque;
+    long r0 = status_mib("VmRSS:");
+    std::mutex m;
+    std::condition_variable cv;
+    deque *slot = nullptr;
+    bool done = false;
+    std::thread consumer([&] {
+        std::unique_lock<std::mutex> guard(m);
+        for (;;) {
+            cv.wait(guard, [&] { return slot != nullptr || done; });
+            if (slot == nullptr)
+                return;
+            delete slot;
+            slot = nullptr;
+            cv.notify_all();
+        }
+    });
+    for (int r = 0; r < 100; ++r) {
+        deque *d = new deque;
+        for (int i = 0; i < 100000; ++i)
+            d->push_back(i);
+        std::unique_lock<std::mutex> guard(m);
+        cv.wait(guard, [&] { return slot == nullptr; });
+        slot = d;
+        cv.notify_all();
+    }
+    {
+        std::unique_lock<std::mutex> guard(m);
+        cv.wait(guard, [&] { return slot == nullptr; });
+        done = true;
+        cv.notify_all();
+    }
+    consumer.join();
+    std::printf("%-40s RSS +%ld MiB\n", name, status_mib("VmRSS:") - r0);
+}
+
+template<class A>
+void short_threads(const char *name) {
+    typedef sjtu::deque<int, A> deque;
+    long v0 = status_mib("VmSize:"), r0 = status_mib("VmRSS:");
+    for (int r = 0; r < 50; ++r) {
+        std::thread th[4];
+        for (int t = 0; t < 4; ++t)
+            th[t] = std::thread([] {
+                deque d;
+                for (int i = 0; i < 20000; ++i)
+                    d.push_back(i);
+            });
+        for (int t = 0; t < 4; ++t)
+            th[t].join();
+    }
+    std::printf("%-40s VmSize +%ld MiB, RSS +%ld MiB\n", name,
+                status_mib("VmSize:") - v0, status_mib("VmRSS:") - r0);
+}
+
+int main(int argc, char **argv) {
+    size_t n = bench::arg(argc, argv, 1, 4000000);
+    producer_consumer<sjtu::heap_allocator>("heap 100 handed-off deques");
+    producer_consumer<sjtu::arena_allocator>("arena 100 handed-off deques");
+    short_threads<sjtu::heap_allocator>("heap 200 short-lived threads");
+    short_threads<sjtu::arena_allocator>("arena 200 short-lived threads");
+    throughput<sjtu::heap_allocator>("heap", n);
+    throughput<sjtu::arena_allocator>("arena", n);
+    return 0;
+}
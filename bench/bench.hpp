@@ -0,0 +1,42 @@
+#ifndef SJTU_BENCH_HPP
+#define SJTU_BENCH_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+namespace bench {
+
+    inline double now_ms() {
+        return std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * print one result line: total time, time per operation and throughput.
+     */
+    inline void report(const char *name, size_t ops, double ms) {
+        std::printf("%-40s %10.1f ms %9.2f ns/op %9.2f Mop/s\n",
+                    name, ms, ms * 1e6 / (double) ops, (double) ops / ms / 1e3);
+    }
+
+    /**
+     * keep a computed scalar alive so the measured loop is not optimised away.
+     */
+    template<class T>
+    void keep(T v) {
+        static volatile T sink;
+        sink = v;
+    }
+
+    /**
+     * the i-th command line argument as a number, or def if absent.
+     */
+    inline size_t arg(int argc, char **argv, int i, size_t def) {
+        return i < argc ? (size_t) std::strtoull(argv[i], nullptr, 10) : def;
+    }
+
+}
+
+#endif
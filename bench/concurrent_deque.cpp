@@ -0,0 +1,93 @@
+/**
+ * reader scan throughput of concurrent_deque with and without a writer
+ * pushing and popping at both ends, against a mutex-guarded sjtu::deque.
+ * usage: bench_concurrent_deque [elements = 1000000] [readers = 2] [scans = 20]
+ */
+#include "bench.hpp"
+#include "concurrent_deque.hpp"
+#include "deque.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+template<class Scan, class Write>
+void run(const char *name, size_t n, size_t readers, size_t scans, bool writer, Scan scan, Write write) {
+    std::atomic<bool> done(false);
+    std::atomic<size_t> writes(0);
+    std::thread w;
+    if (writer)
+        w = std::thread([&] {
+            size_t k = 0;
+            while (!done.load(std::memory_order_relaxed))
+                write(k++);
+            writes.store(k);
+        });
+    double t0 = bench::now_ms();
+    std::vector<std::thread> th;
+    for (size_t r = 0; r < readers; ++r)
+        th.push_back(std::thread([&] {
+            for (size_t i = 0; i < scans; ++i)
+                scan();
+        }));
+    for (size_t r = 0; r < readers; ++r)
+        th[r].join();
+    double ms = bench::now_ms() - t0;
+    done.store(true);
+    if (writer)
+        w.join();
+    bench::report(name, n * readers * scans, ms);
+    if (writer)
+        std::printf("%-40s %10zu writer ops\n", "", writes.load());
+}
+
+int main(int argc, char **argv) {
+    size_t n = bench::arg(argc, argv, 1, 1000000);
+    size_t readers = bench::arg(argc, argv, 2, 2);
+    size_t scans = bench::arg(argc, argv, 3, 20);
+
+    sjtu::concurrent_deque<long> c;
+    sjtu::deque<long> d;
+    std::mutex m;
+    for (size_t i = 0; i < n; ++i) {
+        c.push_back((long) i);
+        d.push_back((long) i);
+    }
+    auto c_scan = [&] {
+        long sum = 0;
+        c.for_each([&sum](const long &v) { sum += v; });
+        bench::keep(sum);
+    };
+    auto c_write = [&](size_t k) {
+        if (k & 1) {
+            c.push_back((long) k);
+            c.pop_front();
+        } else {
+            c.push_front((long) k);
+            c.pop_back();
+        }
+    };
+    auto d_scan = [&] {
+        std::lock_guard<std::mutex> lock(m);
+        long sum = 0;
+        for (sjtu::deque<long>::const_iterator x = d.cbegin(); x != d.cend(); ++x)
+            sum += *x;
+        bench::keep(sum);
+    };
+    auto d_write = [&](size_t k) {
+        std::lock_guard<std::mutex> lock(m);
+        if (k & 1) {
+            d.push_back((long) k);
+            d.pop_front();
+        } else {
+            d.push_front((long) k);
+            d.pop_back();
+        }
+    };
+    run("concurrent_deque scan, idle", n, readers, scans, false, c_scan, c_write);
+    run("concurrent_deque scan, writer", n, readers, scans, true, c_scan, c_write);
+    run("locked deque scan, idle", n, readers, scans, false, d_scan, d_write);
+    run("locked deque scan, writer", n, readers, scans, true, d_scan, d_write);
+    return 0;
+}
@@ -0,0 +1,48 @@
+/**
+ * per-element cost of push_back_n / pop_front_n / drain_front against
+ * element-at-a-time push_back / pop_front, at batch sizes 1 to 4096.
+ * usage: bench_deque_batch [elements per run = 4000000]
+ */
+#include "bench.hpp"
+#include "deque.hpp"
+
+int main(int argc, char **argv) {
+    size_t n = bench::arg(argc, argv, 1, 4000000);
+    static long in[4096], out[4096];
+    for (size_t i = 0; i < 4096; ++i)
+        in[i] = (long) i;
+    std::printf("%-8s %14s %14s %14s\n", "batch", "single ns/el", "_n ns/el", "drain ns/el");
+    for (size_t b = 1; b <= 4096; b *= 4) {
+        sjtu::deque<long> d;
+        for (size_t i = 0; i < 10000; ++i)
+            d.push_back((long) i);
+        long sum = 0;
+        size_t rounds = n / b;
+
+        double t0 = bench::now_ms();
+        for (size_t r = 0; r < rounds; ++r) {
+            for (size_t i = 0; i < b; ++i)
+                d.push_back(in[i]);
+            for (size_t i = 0; i < b; ++i) {
+                out[i] = d.front();
+                d.pop_front();
+            }
+        }
+        double t1 = bench::now_ms();
+        for (size_t r = 0; r < rounds; ++r) {
+            d.push_back_n(in, b);
+            d.pop_front_n(out, b);
+        }
+        double t2 = bench::now_ms();
+        for (size_t r = 0; r < rounds; ++r) {
+            d.push_back_n(in, b);
+            d.drain_front(b, [&sum](long &v) { sum += v; });
+        }
+        double t3 = bench::now_ms();
+        bench::keep(sum + out[0]);
+        double el = (double) (rounds * b);
+        std::printf("%-8zu %14.2f %14.2f %14.2f\n", b,
+                    (t1 - t0) * 1e6 / el, (t2 - t1) * 1e6 / el, (t3 - t2) * 1e6 / el);
+    }
+    return 0;
+}
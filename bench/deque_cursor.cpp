@@ -0,0 +1,49 @@
+/**
+ * indexed sweeps over a deque: forward, backward and strided, through the
+ * deque's own at() (cached), a cursor, and the uncached const at().
+ * usage: bench_deque_cursor [elements = 1000000]
+ */
+#include "bench.hpp"
+#include "deque.hpp"
+
+int main(int argc, char **argv) {
+    size_t n = bench::arg(argc, argv, 1, 1000000);
+    sjtu::deque<long> d;
+    for (size_t i = 0; i < n; ++i)
+        d.push_back((long) i);
+    const sjtu::deque<long> &cd = d;
+    sjtu::deque<long>::cursor c = d.get_cursor();
+    const size_t strides[] = {1, 7, 64};
+    for (size_t k = 0; k < 3; ++k) {
+        size_t st = strides[k], ops = 0;
+        long sum = 0;
+        char name[64];
+
+        double t0 = bench::now_ms();
+        for (size_t i = 0; i < n; i += st, ++ops)
+            sum += d[i];
+        std::snprintf(name, sizeof(name), "at() forward /%zu", st);
+        bench::report(name, ops, bench::now_ms() - t0);
+
+        t0 = bench::now_ms();
+        for (size_t i = 0; i < n; i += st)
+            sum += c[i];
+        std::snprintf(name, sizeof(name), "cursor forward /%zu", st);
+        bench::report(name, ops, bench::now_ms() - t0);
+
+        t0 = bench::now_ms();
+        for (size_t i = n; i > st; i -= st)
+            sum += c[i - 1];
+        std::snprintf(name, sizeof(name), "cursor backward /%zu", st);
+        bench::report(name, ops, bench::now_ms() - t0);
+
+        size_t cops = ops < 20000 ? ops : 20000;
+        t0 = bench::now_ms();
+        for (size_t i = 0, j = 0; j < cops; i += st, ++j)
+            sum += cd[i];
+        std::snprintf(name, sizeof(name), "const at() forward /%zu", st);
+        bench::report(name, cops, bench::now_ms() - t0);
+        bench::keep(sum);
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+/**
+ * bulk walks (copy, drain_front, clear) over a deque whose nodes are
+ * scattered through the heap, at several prefetch_distance settings.
+ * run under `perf stat -e cache-misses,dTLB-load-misses` to see where the
+ * time goes; a distance of 0 is the no-prefetch baseline.
+ * usage: bench_deque_prefetch [elements = 4000000] [repeats = 3]
+ */
+#include "bench.hpp"
+#include "deque.hpp"
+
+#include <cstdlib>
+
+struct big {
+    long v;
+    char pad[120];
+
+    big(long x = 0) : v(x) {}
+};
+
+template<class T>
+void fill(sjtu::deque<T> &d, size_t n) {
+    sjtu::deque<T> junk[8];
+    std::srand(1);
+    for (size_t i = 0; i < n; ++i) {
+        d.push_back(T((long) i));
+        for (int k = std::rand() % 4; k > 0; --k)
+            junk[std::rand() % 8].push_back(T((long) i));
+    }
+}
+
+template<class T>
+void run(const char *type, size_t n, size_t repeats) {
+    static const unsigned distances[] = {0, 2, 8, 32};
+    sjtu::deque<T> d;
+    fill(d, n);
+    for (size_t k = 0; k < 4; ++k) {
+        sjtu::deque<T>::prefetch_distance = distances[k];
+        double copy = 1e18, drain = 1e18, clear = 1e18;
+        long sum = 0;
+        for (size_t r = 0; r < repeats; ++r) {
+            double t0 = bench::now_ms();
+            sjtu::deque<T> c(d);
+            double t1 = bench::now_ms();
+            c.drain_front(n / 2, [&sum](T &v) { sum += *reinterpret_cast<const long *>(&v); });
+            double t2 = bench::now_ms();
+            c.clear();
+            double t3 = bench::now_ms();
+            copy = t1 - t0 < copy ? t1 - t0 : copy;
+            drain = t2 - t1 < drain ? t2 - t1 : drain;
+            clear = t3 - t2 < clear ? t3 - t2 : clear;
+        }
+        bench::keep(sum);
+        char name[64];
+        std::snprintf(name, sizeof(name), "%s copy, distance %u", type, distances[k]);
+        bench::report(name, n, copy);
+        std::snprintf(name, sizeof(name), "%s drain_front, distance %u", type, distances[k]);
+        bench::report(name, n / 2, drain);
+        std::snprintf(name, sizeof(name), "%s clear, distance %u", type, distances[k]);
+        bench::report(name, n - n / 2, clear);
+    }
+    sjtu::deque<T>::prefetch_distance = 8;
+}
+
+int main(int argc, char **argv) {
+    size_t n = bench::arg(argc, argv, 1, 4000000);
+    size_t repeats = bench::arg(argc, argv, 2, 3);
+    run<long>("long", n, repeats);
+    run<big>("128-byte", n / 4, repeats);
+    return 0;
+}
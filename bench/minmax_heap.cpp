@@ -0,0 +1,82 @@
+/**
+ * double-ended priority queue workloads on minmax_heap against std::multiset,
+ * and a min-only workload against std::priority_queue.
+ * usage: bench_minmax_heap [elements = 1000000]
+ */
+#include "bench.hpp"
+#include "minmax_heap.hpp"
+
+#include <functional>
+#include <queue>
+#include <set>
+#include <vector>
+
+int main(int argc, char **argv) {
+    size_t n = bench::arg(argc, argv, 1, 1000000);
+    std::vector<long> keys(n);
+    unsigned long x = 88172645463325252UL;
+    for (size_t i = 0; i < n; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        keys[i] = (long) (x % 1000000007UL);
+    }
+    long sum = 0;
+
+    {
+        sjtu::minmax_heap<long> h;
+        double t0 = bench::now_ms();
+        for (size_t i = 0; i < n; ++i)
+            h.push(keys[i]);
+        for (size_t i = 0; i < n; ++i) {
+            if (i & 1) {
+                sum += h.max();
+                h.pop_max();
+            } else {
+                sum += h.min();
+                h.pop_min();
+            }
+        }
+        bench::report("minmax_heap push, pop both ends", 2 * n, bench::now_ms() - t0);
+    }
+    {
+        std::multiset<long> s;
+        double t0 = bench::now_ms();
+        for (size_t i = 0; i < n; ++i)
+            s.insert(keys[i]);
+        for (size_t i = 0; i < n; ++i) {
+            if (i & 1) {
+                sum += *--s.end();
+                s.erase(--s.end());
+            } else {
+                sum += *s.begin();
+                s.erase(s.begin());
+            }
+        }
+        bench::report("std::multiset push, pop both ends", 2 * n, bench::now_ms() - t0);
+    }
+    {
+        sjtu::minmax_heap<long> h;
+        double t0 = bench::now_ms();
+        for (size_t i = 0; i < n; ++i)
+            h.push(keys[i]);
+        for (size_t i = 0; i < n; ++i) {
+            sum += h.min();
+            h.pop_min();
+        }
+        bench::report("minmax_heap push, pop_min", 2 * n, bench::now_ms() - t0);
+    }
+    {
+        std::priority_queue<long, std::vector<long>, std::greater<long> > q;
+        double t0 = bench::now_ms();
+        for (size_t i = 0; i < n; ++i)
+            q.push(keys[i]);
+        for (size_t i = 0; i < n; ++i) {
+            sum += q.top();
+            q.pop();
+        }
+        bench::report("std::priority_queue push, pop", 2 * n, bench::now_ms() - t0);
+    }
+    bench::keep(sum);
+    return 0;
+}
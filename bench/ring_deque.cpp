@@ -0,0 +1,62 @@
+/**
+ * ring_deque / fixed_deque against the block-linked deque: a bounded FIFO,
+ * random at() and a full scan.
+ * usage: bench_ring_deque [operations = 10000000]
+ */
+#include "bench.hpp"
+#include "deque.hpp"
+#include "ring_deque.hpp"
+
+#include <cstdlib>
+
+template<class Q>
+void run(const char *name, Q &q, size_t cap, size_t ops) {
+    char label[64];
+    for (size_t i = 0; i < cap; ++i)
+        q.push_back((long) i);
+    long sum = 0;
+    double t0 = bench::now_ms();
+    for (size_t i = 0; i < ops; ++i) {
+        sum += q.front();
+        q.pop_front();
+        q.push_back((long) i);
+    }
+    double t1 = bench::now_ms();
+    size_t idx = 12345;
+    size_t reads = ops / 10;
+    for (size_t i = 0; i < reads; ++i) {
+        idx = (idx * 1103515245 + 12345) % cap;
+        sum += q.at(idx);
+    }
+    double t2 = bench::now_ms();
+    for (typename Q::iterator it = q.begin(); it != q.end(); ++it)
+        sum += *it;
+    double t3 = bench::now_ms();
+    bench::keep(sum);
+    std::snprintf(label, sizeof(label), "%s fifo", name);
+    bench::report(label, ops, t1 - t0);
+    std::snprintf(label, sizeof(label), "%s random at", name);
+    bench::report(label, reads, t2 - t1);
+    std::snprintf(label, sizeof(label), "%s scan", name);
+    bench::report(label, cap, t3 - t2);
+}
+
+int main(int argc, char **argv) {
+    size_t ops = bench::arg(argc, argv, 1, 10000000);
+    const size_t caps[] = {1024, (size_t) 1 << 20};
+    for (size_t cap : caps) {
+        std::printf("capacity %zu\n", cap);
+        {
+            sjtu::ring_deque<long> q(cap);
+            run("ring_deque", q, cap, ops);
+        }
+        {
+            sjtu::deque<long> q;
+            run("deque", q, cap, ops);
+        }
+    }
+    std::printf("capacity 1024\n");
+    static sjtu::fixed_deque<long, 1024> f;
+    run("fixed_deque", f, 1024, ops);
+    return 0;
+}
@@ -0,0 +1,61 @@
+/**
+ * FIFO throughput of spill_deque when the queue is twice its memory budget.
+ * usage: bench_spill_fifo [queue MiB = 256] [budget MiB = queue / 2]
+ * pass a queue size of twice the machine's RAM (and a budget below RAM) to
+ * reproduce a larger-than-memory backlog; the defaults fit any machine and
+ * keep the same 2:1 ratio between queue and budget.
+ */
+#include "bench.hpp"
+#include "deque.hpp"
+#include "spill_deque.hpp"
+
+template<class Q>
+void fifo(const char *name, Q &q, size_t n) {
+    char label[64];
+    double t0 = bench::now_ms();
+    for (size_t i = 0; i < n; ++i)
+        q.push_back((long) i);
+    double t1 = bench::now_ms();
+    long sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        q.push_back((long) i);
+        sum += q.front();
+        q.pop_front();
+    }
+    double t2 = bench::now_ms();
+    for (size_t i = 0; i < n; ++i) {
+        sum += q.front();
+        q.pop_front();
+    }
+    double t3 = bench::now_ms();
+    bench::keep(sum);
+    std::snprintf(label, sizeof(label), "%s fill", name);
+    bench::report(label, n, t1 - t0);
+    std::snprintf(label, sizeof(label), "%s steady push+pop", name);
+    bench::report(label, n, t2 - t1);
+    std::snprintf(label, sizeof(label), "%s drain", name);
+    bench::report(label, n, t3 - t2);
+}
+
+int main(int argc, char **argv) {
+    size_t queue_mib = bench::arg(argc, argv, 1, 256);
+    size_t budget_mib = bench::arg(argc, argv, 2, queue_mib / 2);
+    size_t n = (queue_mib << 20) / sizeof(long);
+    size_t block_bytes = 4096 * sizeof(long);
+    size_t budget = (budget_mib << 20) / block_bytes;
+    std::printf("queue %zu MiB (%zu elements), budget %zu MiB (%zu blocks)\n",
+                queue_mib, n, budget_mib, budget);
+    {
+        sjtu::spill_deque<long> q(budget);
+        fifo("spill_deque, budget", q, n);
+    }
+    {
+        sjtu::spill_deque<long> q(2 * n / 4096 + 3);
+        fifo("spill_deque, all resident", q, n);
+    }
+    {
+        sjtu::deque<long> q;
+        fifo("deque", q, n);
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+/**
+ * per-sample cost of sliding a window over a stream with window_extremum and
+ * window_aggregator, against rescanning a std::deque window (timed at 200
+ * points of the stream), at window sizes from 10 to 1e7.
+ * usage: bench_window_aggregator [samples = 20000000] [largest window = 10000000]
+ */
+#include "bench.hpp"
+#include "window_aggregator.hpp"
+
+#include <deque>
+#include <functional>
+
+static long sample(size_t i) {
+    return (long) ((i * 2654435761UL) % 1000003UL);
+}
+
+int main(int argc, char **argv) {
+    size_t n = bench::arg(argc, argv, 1, 20000000);
+    size_t top = bench::arg(argc, argv, 2, 10000000);
+    std::printf("%-10s %14s %14s %18s\n", "window", "max ns/el", "sum ns/el", "rescan ns/query");
+    for (size_t w = 10; w <= top; w *= 10) {
+        size_t total = n > 2 * w ? n : 2 * w;
+        long acc = 0;
+
+        sjtu::window_extremum<long> mx;
+        double t0 = bench::now_ms();
+        for (size_t i = 0; i < total; ++i) {
+            mx.push(sample(i));
+            if (i >= w)
+                mx.pop();
+            acc += mx.query();
+        }
+        double t1 = bench::now_ms();
+
+        sjtu::window_aggregator<long, std::plus<long> > sum;
+        double t2 = bench::now_ms();
+        for (size_t i = 0; i < total; ++i) {
+            sum.push(sample(i));
+            if (i >= w)
+                sum.pop();
+            acc += sum.query();
+        }
+        double t3 = bench::now_ms();
+
+        std::deque<long> win;
+        size_t queries = 0, every = total / 200;
+        double rescan = 0;
+        for (size_t i = 0; i < total; ++i) {
+            win.push_back(sample(i));
+            if (i >= w)
+                win.pop_front();
+            if (i % every == 0) {
+                double r0 = bench::now_ms();
+                long m = win.front();
+                for (size_t j = 0; j < win.size(); ++j)
+                    m = win[j] > m ? win[j] : m;
+                rescan += bench::now_ms() - r0;
+                acc += m;
+                ++queries;
+            }
+        }
+        bench::keep(acc);
+        std::printf("%-10zu %14.2f %14.2f %18.1f\n", w,
+                    (t1 - t0) * 1e6 / (double) total, (t3 - t2) * 1e6 / (double) total,
+                    rescan * 1e6 / (double) queries);
+    }
+    return 0;
+}
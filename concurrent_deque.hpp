@@ -0,0 +1,293 @@
+#ifndef SJTU_CONCURRENT_DEQUE_HPP
+#define SJTU_CONCURRENT_DEQUE_HPP
+
+#include "exceptions.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+namespace sjtu {
+
+    /**
+     * a block-chained deque with one writer and lock-free readers.
+     * the writer calls push/pop at both ends; any number of threads (up to
+     * max_readers at a time) may call for_each concurrently. elements and
+     * blocks removed by the writer are retired and only freed once every
+     * reader that could still see them has left (epoch-based reclamation),
+     * so readers never take a lock and the writer never waits for them.
+     */
+    template<class T>
+    class concurrent_deque {
+        static const size_t len = 256;
+        static const size_t max_readers = 64;
+        static const size_t reclaim_batch = 64;
+
+        class block {
+            friend class concurrent_deque;
+
+            std::atomic<size_t> beg;
+            std::atomic<size_t> end;
+            std::atomic<block *> nex;
+            block *pre;
+            bool popped;
+            std::atomic<T *> val[len];
+
+            block(size_t b) : beg(b), end(b), nex(nullptr), pre(nullptr), popped(false) {
+                for (size_t i = 0; i < len; ++i)
+                    val[i].store(nullptr, std::memory_order_relaxed);
+            }
+        };
+
+        struct garbage {
+            T *val;
+            block *blk;
+            size_t epoch;
+        };
+
+        class reader_guard {
+            const concurrent_deque *deque_;
+            size_t id_;
+
+        public:
+            reader_guard(const concurrent_deque *d) : deque_(d) {
+                id_ = d->enter();
+            }
+            ~reader_guard() {
+                deque_->readers[id_].store(0);
+            }
+        };
+
+    private:
+        std::atomic<block *> head;
+        block *tail;
+        std::atomic<size_t> siz;
+        mutable std::atomic<size_t> epoch;
+        mutable std::atomic<size_t> readers[max_readers];
+        garbage *bin;
+        size_t bin_beg;
+        size_t bin_end;
+        size_t bin_cap;
+
+        size_t enter() const {
+            for (size_t i = 0; i < max_readers; ++i) {
+                size_t expected = 0;
+                if (readers[i].load(std::memory_order_relaxed) == 0 &&
+                    readers[i].compare_exchange_strong(expected, epoch.load()))
+                    return i;
+            }
+            throw runtime_error();
+        }
+
+        void retire(T *v, block *b) {
+            if (bin_end == bin_cap) {
+                size_t cnt = bin_end - bin_beg;
+                size_t cap = cnt * 2 < reclaim_batch ? reclaim_batch : cnt * 2;
+                garbage *tmp = new garbage[cap];
+                for (size_t i = 0; i < cnt; ++i)
+                    tmp[i] = bin[bin_beg + i];
+                delete[] bin;
+                bin = tmp;
+                bin_beg = 0;
+                bin_end = cnt;
+                bin_cap = cap;
+            }
+            bin[bin_end].val = v;
+            bin[bin_end].blk = b;
+            bin[bin_end].epoch = epoch.load();
+            ++bin_end;
+            if (bin_end - bin_beg >= reclaim_batch)
+                reclaim();
+        }
+
+        static void destroy(block *b) {
+            for (size_t i = b->beg.load(); i < b->end.load(); ++i)
+                delete b->val[i].load();
+            delete b;
+        }
+
+    public:
+        concurrent_deque() : head(nullptr), tail(nullptr), siz(0), epoch(1),
+                             bin(nullptr), bin_beg(0), bin_end(0), bin_cap(0) {
+            for (size_t i = 0; i < max_readers; ++i)
+                readers[i].store(0, std::memory_order_relaxed);
+        }
+
+        concurrent_deque(const concurrent_deque &other) = delete;
+        concurrent_deque &operator=(const concurrent_deque &other) = delete;
+
+        ~concurrent_deque() {
+            block *cur = head.load();
+            while (cur != nullptr) {
+                block *tmp = cur->nex.load();
+                destroy(cur);
+                cur = tmp;
+            }
+            for (size_t i = bin_beg; i < bin_end; ++i) {
+                delete bin[i].val;
+                delete bin[i].blk;
+            }
+            delete[] bin;
+        }
+
+        /**
+         * free everything retired before the oldest active reader started.
+         * writer only; called automatically every reclaim_batch retirements.
+         */
+        void reclaim() {
+            size_t oldest = epoch.fetch_add(1) + 1;
+            for (size_t i = 0; i < max_readers; ++i) {
+                size_t e = readers[i].load();
+                if (e != 0 && e < oldest)
+                    oldest = e;
+            }
+            while (bin_beg < bin_end && bin[bin_beg].epoch < oldest) {
+                delete bin[bin_beg].val;
+                delete bin[bin_beg].blk;
+                ++bin_beg;
+            }
+            if (bin_beg == bin_end)
+                bin_beg = bin_end = 0;
+        }
+
+        /**
+         * call f on every element from front to back without locking.
+         * may run concurrently with the writer; elements pushed or popped
+         * during the scan may or may not be visited, but the ones visited
+         * always come in deque order, since push_front never refills a slot
+         * that pop_front has emptied.
+         */
+        template<class F>
+        void for_each(F f) const {
+            reader_guard guard(this);
+            for (block *cur = head.load(); cur != nullptr; cur = cur->nex.load()) {
+                size_t e = cur->end.load();
+                for (size_t i = cur->beg.load(); i < e; ++i) {
+                    T *v = cur->val[i].load(std::memory_order_acquire);
+                    if (v != nullptr)
+                        f(static_cast<const T &>(*v));
+                }
+            }
+        }
+
+        /**
+         * front() and back() read the ends without a reader guard, so only
+         * the writer may call them.
+         */
+        const T &front() const {
+            if (siz.load(std::memory_order_relaxed) == 0)
+                throw container_is_empty();
+            block *cur = head.load(std::memory_order_relaxed);
+            return *cur->val[cur->beg.load(std::memory_order_relaxed)].load(std::memory_order_relaxed);
+        }
+
+        const T &back() const {
+            if (siz.load(std::memory_order_relaxed) == 0)
+                throw container_is_empty();
+            return *tail->val[tail->end.load(std::memory_order_relaxed) - 1].load(std::memory_order_relaxed);
+        }
+
+        bool empty() const {
+            return siz.load(std::memory_order_relaxed) == 0;
+        }
+
+        size_t size() const {
+            return siz.load(std::memory_order_relaxed);
+        }
+
+        void push_back(const T &value) {
+            T *v = new T(value);
+            block *cur = tail;
+            if (cur == nullptr || cur->end.load(std::memory_order_relaxed) == len) {
+                block *tmp;
+                try {
+                    tmp = new block(0);
+                } catch (...) {
+                    delete v;
+                    throw;
+                }
+                tmp->pre = cur;
+                if (cur == nullptr)
+                    head.store(tmp);
+                else
+                    cur->nex.store(tmp);
+                tail = cur = tmp;
+            }
+            size_t e = cur->end.load(std::memory_order_relaxed);
+            cur->val[e].store(v);
+            cur->end.store(e + 1);
+            siz.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void push_front(const T &value) {
+            T *v = new T(value);
+            block *cur = head.load(std::memory_order_relaxed);
+            if (cur == nullptr || cur->beg.load(std::memory_order_relaxed) == 0 || cur->popped) {
+                block *tmp;
+                try {
+                    tmp = new block(len);
+                } catch (...) {
+                    delete v;
+                    throw;
+                }
+                tmp->nex.store(cur, std::memory_order_relaxed);
+                if (cur == nullptr)
+                    tail = tmp;
+                else
+                    cur->pre = tmp;
+                head.store(tmp);
+                cur = tmp;
+            }
+            size_t b = cur->beg.load(std::memory_order_relaxed) - 1;
+            cur->val[b].store(v);
+            cur->beg.store(b);
+            siz.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void pop_front() {
+            if (siz.load(std::memory_order_relaxed) == 0)
+                throw container_is_empty();
+            block *cur = head.load(std::memory_order_relaxed);
+            size_t b = cur->beg.load(std::memory_order_relaxed);
+            T *v = cur->val[b].load(std::memory_order_relaxed);
+            cur->val[b].store(nullptr);
+            cur->beg.store(b + 1);
+            cur->popped = true;
+            siz.fetch_sub(1, std::memory_order_relaxed);
+            block *dead = nullptr;
+            if (b + 1 == cur->end.load(std::memory_order_relaxed)) {
+                block *tmp = cur->nex.load(std::memory_order_relaxed);
+                head.store(tmp);
+                if (tmp == nullptr)
+                    tail = nullptr;
+                else
+                    tmp->pre = nullptr;
+                dead = cur;
+            }
+            retire(v, dead);
+        }
+
+        void pop_back() {
+            if (siz.load(std::memory_order_relaxed) == 0)
+                throw container_is_empty();
+            block *cur = tail;
+            size_t e = cur->end.load(std::memory_order_relaxed) - 1;
+            T *v = cur->val[e].load(std::memory_order_relaxed);
+            cur->val[e].store(nullptr);
+            cur->end.store(e);
+            siz.fetch_sub(1, std::memory_order_relaxed);
+            block *dead = nullptr;
+            if (e == cur->beg.load(std::memory_order_relaxed)) {
+                tail = cur->pre;
+                if (tail == nullptr)
+                    head.store(nullptr);
+                else
+                    tail->nex.store(nullptr);
+                dead = cur;
+            }
+            retire(v, dead);
+        }
+    };
+
+}
+
+#endif
@@ -1,16 +1,40 @@
 #ifndef SJTU_DEQUE_HPP
 #define SJTU_DEQUE_HPP
 
+#include "allocator.hpp"
 #include "exceptions.hpp"
 
 #include <cstddef>
+#include <functional>
+#include <new>
+
+#ifndef SJTU_PREFETCH
+#if defined(__GNUC__) || defined(__clang__)
+#define SJTU_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define SJTU_PREFETCH(p) ((void) 0)
+#endif
+#endif
 
 namespace sjtu {
 
-    template<class T>
+    /**
+     * Alloc supplies the memory for nodes and blocks, see allocator.hpp.
+     */
+    template<class T, class Alloc = heap_allocator>
     class deque {
         static const int len = 600;
 
+        /**
+         * small values live inside their node; larger ones are allocated on
+         * their own and the node keeps only the pointer, so sentinels, the
+         * inline pool and node-to-node walks stay compact for big T.
+         * nodes are linked, so neither layout ever moves a value.
+         */
+        static const size_t inline_limit = 64;
+        static const bool inline_val = sizeof(T) <= inline_limit;
+        static const size_t small_len = inline_val ? 16 : 4;
+
         class block;
 
         class node {
@@ -20,14 +44,35 @@ namespace sjtu {
             node *pre;
             T *val;
             node *nex;
+            block *own;
+            alignas(inline_val ? alignof(T) : 1) unsigned char buf[inline_val ? sizeof(T) : 1];
 
-            node() : pre(nullptr), val(nullptr), nex(nullptr) {};
-            node(node *p, node *n) : pre(p), val(nullptr), nex(n) {};
-            node(const T &v) : pre(nullptr), nex(nullptr) {
-                val = new T(v);
-            }
+            node() : pre(nullptr), val(nullptr), nex(nullptr), own(nullptr) {};
+            node(node *p, node *n) : pre(p), val(nullptr), nex(n), own(nullptr) {};
             ~node() {
-                delete val;
+                reset();
+            }
+
+            void set(const T &v) {
+                if (inline_val) {
+                    val = new(buf) T(v);
+                    return;
+                }
+                void *p = Alloc::allocate(sizeof(T));
+                try {
+                    val = new(p) T(v);
+                } catch (...) {
+                    Alloc::deallocate(p, sizeof(T));
+                    throw;
+                }
+            }
+            void reset() {
+                if (val != nullptr) {
+                    val->~T();
+                    if (!inline_val)
+                        Alloc::deallocate(val, sizeof(T));
+                    val = nullptr;
+                }
             }
         };
 
@@ -41,70 +86,20 @@ namespace sjtu {
             block *nex;
             node *bh;
             node *bt;
+            node hd;
+            node tl;
 
-            block() : siz(0), pre(nullptr), nex(nullptr) {
-                bh = new node;
-                bt = new node;
+            block() : siz(0), pre(nullptr), nex(nullptr), bh(&hd), bt(&tl) {
                 bh->nex = bt;
                 bt->pre = bh;
             }
-            block(block *p, block *n, node *tmp) : siz(1), pre(p), nex(n) {
-                bh = new node(nullptr, tmp);
-                bt = new node(tmp, nullptr);
-                tmp->pre = bh;
-                tmp->nex = bt;
-            }
-            block(const block *other) {
-                bh = new node;
-                bt = new node;
-                node *cur = bh;
-                node *pos = other->bh->nex;
-                siz = other->siz;
-                for (size_t i = 1; i <= siz; ++i) {
-                    node *p = new node;
-                    p->val = new T(*pos->val);
-                    p->pre = cur;
-                    cur->nex = p;
-                    cur = p;
-                    pos = pos->nex;
-                }
-                cur->nex = bt;
-                bt->pre = cur;
-            }
-
-            ~block() {
-                node *tmp = bh;
-                while (tmp != bt) {
-                    tmp = tmp->nex;
-                    delete tmp->pre;
-                }
-                delete tmp;
-            }
-
-            block &operator=(const block &other) {
-                if (this == &other)
-                    return *this;
-                node *tmp = bh->nex;
-                while (tmp != bt) {
-                    tmp = tmp->nex;
-                    delete tmp->pre;
-                }
-                pre = other.pre;
-                nex = other.nex;
-                node *cur = bh;
-                node *pos = other->bh->nex;
-                siz = other->siz;
-                for (size_t i = 1; i <= siz; ++i) {
-                    node *p = new node;
-                    p->val = new T(pos->val);
-                    p->pre = cur;
-                    cur->nex = p;
-                    cur = p;
-                    pos = pos->nex;
-                }
-                cur->nex = bt;
-                bt->pre = cur;
-                return *this;
+
+            void init(block *p, block *n) {
+                siz = 0;
+                pre = p;
+                nex = n;
+                bh->nex = bt;
+                bt->pre = bh;
             }
         };
 
@@ -113,7 +108,264 @@ namespace sjtu {
         size_t num;
         block *h;
         block *t;
+        block hb;
+        block tb;
+        node *spare;
+        bool small_used;
+        block small_block;
+        node small_node[small_len];
+        block *cb;
+        size_t cs;
+        node *cn;
+        size_t cp;
+
+        static node *alloc_node() {
+            return new(Alloc::allocate(sizeof(node))) node;
+        }
+
+        static void free_node(node *p) {
+            p->~node();
+            Alloc::deallocate(p, sizeof(node));
+        }
+
+        static block *alloc_block() {
+            return new(Alloc::allocate(sizeof(block))) block;
+        }
+
+        static void free_block(block *b) {
+            b->~block();
+            Alloc::deallocate(b, sizeof(block));
+        }
+
+        void init_small() {
+            spare = nullptr;
+            for (size_t i = small_len; i > 0; --i) {
+                small_node[i - 1].nex = spare;
+                spare = small_node + i - 1;
+            }
+            small_used = false;
+        }
+
+        bool is_small(const node *p) const {
+            return std::less_equal<const node *>()(small_node, p) &&
+                   std::less<const node *>()(p, small_node + small_len);
+        }
+
+        node *new_node(const T &value) {
+            node *tmp;
+            if (spare != nullptr) {
+                tmp = spare;
+                spare = spare->nex;
+            } else {
+                tmp = alloc_node();
+            }
+            try {
+                tmp->set(value);
+            } catch (...) {
+                del_node(tmp);
+                throw;
+            }
+            return tmp;
+        }
+
+        void del_node(node *p) {
+            p->reset();
+            if (is_small(p)) {
+                p->nex = spare;
+                spare = p;
+            } else {
+                free_node(p);
+            }
+        }
+
+        block *new_block(block *p, block *n) {
+            block *tmp;
+            if (!small_used) {
+                small_used = true;
+                tmp = &small_block;
+            } else {
+                tmp = alloc_block();
+            }
+            tmp->init(p, n);
+            return tmp;
+        }
+
+        block *new_block(block *p, block *n, node *first) {
+            block *tmp = new_block(p, n);
+            tmp->siz = 1;
+            first->own = tmp;
+            first->pre = tmp->bh;
+            first->nex = tmp->bt;
+            tmp->bh->nex = first;
+            tmp->bt->pre = first;
+            return tmp;
+        }
+
+        /**
+         * nodes are reached by dependent loads, so bulk walks keep a second
+         * pointer prefetch_distance nodes ahead: lead() places it and
+         * step() advances it by one and prefetches the node it lands on.
+         */
+        static const node *lead(const node *x, const node *end) {
+            for (unsigned i = 0; i < prefetch_distance && x != end; ++i)
+                x = x->nex;
+            return x;
+        }
+
+        static void step(const node *&ahead, const node *end) {
+            if (ahead != end) {
+                ahead = ahead->nex;
+                SJTU_PREFETCH(ahead);
+            }
+        }
+
+        void del_block(block *b) {
+            node *tmp = b->bh->nex;
+            const node *ahead = lead(tmp, b->bt);
+            while (tmp != b->bt) {
+                step(ahead, b->bt);
+                tmp = tmp->nex;
+                del_node(tmp->pre);
+            }
+            if (b == &small_block)
+                small_used = false;
+            else
+                free_block(b);
+        }
+
+        void cut_front(block *cur, node *stop, size_t k) {
+            cb = nullptr;
+            if (k == 0)
+                return;
+            siz -= k;
+            if (k == cur->siz) {
+                --num;
+                cur->pre->nex = cur->nex;
+                cur->nex->pre = cur->pre;
+                del_block(cur);
+                return;
+            }
+            node *tmp = cur->bh->nex;
+            while (tmp != stop) {
+                tmp = tmp->nex;
+                del_node(tmp->pre);
+            }
+            cur->bh->nex = stop;
+            stop->pre = cur->bh;
+            cur->siz -= k;
+        }
+
+        void cut_back(block *cur, node *stop, size_t k) {
+            cb = nullptr;
+            if (k == 0)
+                return;
+            siz -= k;
+            if (k == cur->siz) {
+                --num;
+                cur->pre->nex = cur->nex;
+                cur->nex->pre = cur->pre;
+                del_block(cur);
+                return;
+            }
+            node *tmp = cur->bt->pre;
+            while (tmp != stop) {
+                tmp = tmp->pre;
+                del_node(tmp->nex);
+            }
+            cur->bt->pre = stop;
+            stop->nex = cur->bt;
+            cur->siz -= k;
+        }
+
+        /**
+         * move (b, start, n, p) to the element at index pos, where start is the
+         * index of b's first element and n is the p-th node of b.
+         * the walk starts from the given position, or from the nearer end of
+         * the deque when that is closer (or b is nullptr).
+         */
+        void seek(size_t pos, block *&b, size_t &start, node *&n, size_t &p) const {
+            size_t dist = b == nullptr ? siz : (pos < start ? start - pos : pos - start);
+            if (pos < dist || siz - pos < dist) {
+                if (pos < siz - pos) {
+                    b = h->nex;
+                    start = 0;
+                    n = b->bh;
+                    p = 0;
+                } else {
+                    b = t->pre;
+                    start = siz - b->siz;
+                    n = b->bt;
+                    p = b->siz + 1;
+                }
+            }
+            while (pos < start) {
+                b = b->pre;
+                start -= b->siz;
+                n = b->bt;
+                p = b->siz + 1;
+            }
+            while (pos >= start + b->siz) {
+                start += b->siz;
+                b = b->nex;
+                n = b->bh;
+                p = 0;
+            }
+            size_t target = pos - start + 1;
+            size_t near = p < target ? target - p : p - target;
+            if (target < near) {
+                n = b->bh;
+                p = 0;
+            } else if (b->siz + 1 - target < near) {
+                n = b->bt;
+                p = b->siz + 1;
+            }
+            for (; p < target; ++p)
+                n = n->nex;
+            for (; p > target; --p)
+                n = n->pre;
+        }
+
+        /**
+         * append copies of other's nodes to cur.
+         */
+        void fill_block(block *cur, const block *other) {
+            const node *ahead = lead(other->bh->nex, other->bt);
+            for (const node *x = other->bh->nex; x != other->bt; x = x->nex) {
+                step(ahead, other->bt);
+                node *tmp = new_node(*x->val);
+                tmp->own = cur;
+                tmp->pre = cur->bt->pre;
+                tmp->nex = cur->bt;
+                tmp->pre->nex = tmp;
+                tmp->nex->pre = tmp;
+                ++cur->siz;
+            }
+        }
+
+        void copy_from(const deque &other) {
+            for (const block *pos = other.h->nex; pos != other.t; pos = pos->nex) {
+                block *cur = new_block(t->pre, t);
+                cur->pre->nex = cur;
+                t->pre = cur;
+                ++num;
+                try {
+                    fill_block(cur, pos);
+                } catch (...) {
+                    siz += cur->siz;
+                    throw;
+                }
+                siz += cur->siz;
+            }
+        }
+
     public:
+        /**
+         * how many nodes ahead bulk traversals (copy, clear, drain_front)
+         * prefetch; 0 turns the lookahead off. shared by every deque<T, Alloc>
+         * and not synchronised, so set it before other threads use deques.
+         */
+        static unsigned prefetch_distance;
+
         class const_iterator;
 
         class iterator {
@@ -343,7 +595,7 @@ namespace sjtu {
                     throw invalid_iterator();
                 else return *node_->val;
             }
-            T *operator->() const noexcept {
+            T *operator->() const {
                 if (block_->nex == deque_->t && pos_ == block_->siz + 1)
                     throw invalid_iterator();
                 else return &*node_->val;
@@ -586,7 +838,7 @@ namespace sjtu {
                     throw invalid_iterator();
                 else return *node_->val;
             }
-            const T *operator->() const noexcept {
+            const T *operator->() const {
                 if (block_->nex == deque_->t && pos_ == block_->siz + 1)
                     throw invalid_iterator();
                 else return &*node_->val;
@@ -605,98 +857,143 @@ namespace sjtu {
             }
         };
 
-        deque() : num(0), siz(0) {
-            h = new block;
-            t = new block;
+        /**
+         * indexed access that walks from the previously visited element, so
+         * sweeps like c[i], c[i + 1], ... or c[i], c[i - k], ... only move a
+         * few nodes per step. invalidated by the same operations as iterators.
+         */
+        class cursor {
+            friend class deque;
+
+        private:
+            deque *deque_;
+            block *block_;
+            size_t start_;
+            node *node_;
+            size_t pos_;
+
+        public:
+            cursor() : deque_(nullptr), block_(nullptr), start_(0), node_(nullptr), pos_(0) {}
+            explicit cursor(deque *d) : deque_(d), block_(nullptr), start_(0), node_(nullptr), pos_(0) {}
+
+            T &at(const size_t &pos) {
+                if (pos >= deque_->siz)
+                    throw index_out_of_bound();
+                deque_->seek(pos, block_, start_, node_, pos_);
+                return *node_->val;
+            }
+
+            T &operator[](const size_t &pos) {
+                return at(pos);
+            }
+        };
+
+        /**
+         * refers to one element for as long as that element stays in the deque,
+         * no matter what is inserted or erased around it.
+         */
+        class handle {
+            friend class deque;
+
+        private:
+            const deque *deque_;
+            node *node_;
+
+            handle(const deque *d, node *n) : deque_(d), node_(n) {}
+
+        public:
+            handle() : deque_(nullptr), node_(nullptr) {}
+
+            T &operator*() const {
+                if (node_ == nullptr)
+                    throw invalid_iterator();
+                return *node_->val;
+            }
+            T *operator->() const {
+                return &**this;
+            }
+            bool operator==(const handle &rhs) const {
+                return node_ == rhs.node_;
+            }
+            bool operator!=(const handle &rhs) const {
+                return node_ != rhs.node_;
+            }
+        };
+
+        deque() : siz(0), num(0), h(&hb), t(&tb), cb(nullptr) {
+            init_small();
             h->nex = t;
             t->pre = h;
         }
 
-        deque(const deque &other) {
-            h = new block;
-            t = new block;
-            block *cur = h;
-            const block *pos = other.h->nex;
-            num = other.num;
-            siz = other.siz;
-            for (size_t i = 1; i <= num; ++i) {
-                block *p = new block(pos);
-                p->pre = cur;
-                cur->nex = p;
-                cur = p;
-                pos = pos->nex;
+        deque(const deque &other) : siz(0), num(0), h(&hb), t(&tb), cb(nullptr) {
+            init_small();
+            h->nex = t;
+            t->pre = h;
+            try {
+                copy_from(other);
+            } catch (...) {
+                clear();
+                throw;
             }
-            cur->nex = t;
-            t->pre = cur;
         }
 
         ~deque() {
-            for (block *tmp = h->nex; tmp != nullptr; tmp = tmp->nex) {
-                delete tmp->pre;
-            }
-            delete t;
+            clear();
         }
 
         deque &operator=(const deque &other) {
             if (this == &other)
                 return *this;
-            for (block *tmp = h->nex->nex; tmp != nullptr; tmp = tmp->nex) {
-                delete tmp->pre;
-            }
-            block *cur = h;
-            block *pos = other.h->nex;
-            num = other.num;
-            siz = other.siz;
-            for (size_t i = 1; i <= num; ++i) {
-                block *p = new block(pos);
-                p->pre = cur;
-                cur->nex = p;
-                cur = p;
-                pos = pos->nex;
-            }
-            cur->nex = t;
-            t->pre = cur;
+            clear();
+            try {
+                copy_from(other);
+            } catch (...) {
+                clear();
+                throw;
+            }
             return *this;
         }
 
         T &at(const size_t &pos) {
             if (pos >= siz)
                 throw index_out_of_bound();
-            int step = pos + 1;
-            block *tmp1 = h->nex;
-            node *tmp2 = tmp1->bh;
-            while (step > 0) {
-                if (step > tmp1->siz) {
-                    step -= tmp1->siz;
-                    tmp1 = tmp1->nex;
-                    tmp2 = tmp1->bh;
-                    continue;
-                }
-                for (; step > 0; --step) {
-                    tmp2 = tmp2->nex;
-                }
-                return *tmp2->val;
-            }
+            seek(pos, cb, cs, cn, cp);
+            return *cn->val;
         }
 
+        /**
+         * the const overloads leave the cache alone and walk from the nearer
+         * end, so concurrent reads of a const deque stay safe.
+         */
         const T &at(const size_t &pos) const {
             if (pos >= siz)
                 throw index_out_of_bound();
-            int step = pos + 1;
-            block *tmp1 = h->nex;
-            node *tmp2 = tmp1->bh;
-            while (step > 0) {
-                if (step > tmp1->siz) {
-                    step -= tmp1->siz;
-                    tmp1 = tmp1->nex;
-                    tmp2 = tmp1->bh;
-                    continue;
-                }
-                for (; step > 0; --step) {
-                    tmp2 = tmp2->nex;
-                }
-                return *tmp2->val;
-            }
+            block *b = nullptr;
+            size_t start = 0, p = 0;
+            node *n = nullptr;
+            seek(pos, b, start, n, p);
+            return *n->val;
+        }
+
+        /**
+         * non-throwing at(): nullptr when pos is out of range.
+         */
+        T *try_at(const size_t &pos) noexcept {
+            if (pos >= siz)
+                return nullptr;
+            seek(pos, cb, cs, cn, cp);
+            return cn->val;
+        }
+
+        const T *try_at(const size_t &pos) const noexcept {
+            if (pos >= siz)
+                return nullptr;
+            block *b = nullptr;
+            size_t start = 0, p = 0;
+            node *n = nullptr;
+            seek(pos, b, start, n, p);
+            return n->val;
         }
 
         T &operator[](const size_t &pos) {
@@ -719,6 +1016,10 @@ namespace sjtu {
             return *t->pre->bt->pre->val;
         }
 
+        cursor get_cursor() {
+            return cursor(this);
+        }
+
         iterator begin() {
             if (siz != 0) return iterator(this, h->nex, 1, h->nex->bh->nex, 1);
             else return iterator(this, h, 0, h->bt, 1);
@@ -737,17 +1038,18 @@ namespace sjtu {
             return const_iterator(this, t->pre, num, t->pre->bt, t->pre->siz + 1);
         }
 
-        bool empty() const {
+        bool empty() const noexcept {
             return siz == 0;
         }
 
-        size_t size() const {
+        size_t size() const noexcept {
             return siz;
         }
 
         void clear() {
+            cb = nullptr;
             for (block *tmp = h->nex->nex; tmp != nullptr; tmp = tmp->nex) {
-                delete tmp->pre;
+                del_block(tmp->pre);
             }
             h->nex = t;
             t->pre = h;
@@ -758,17 +1060,19 @@ namespace sjtu {
         iterator insert(iterator pos, const T &value) {
             if (this != pos.deque_)
                 throw invalid_iterator();
+            cb = nullptr;
+            node *cur = new_node(value);
             ++siz;
             if (pos.num_ == 0) {
                 ++num;
-                node *tmp = new node(value);
-                block *cur = new block(h, t, tmp);
-                h->nex = cur;
-                t->pre = cur;
-                return iterator(this, cur, 1, tmp, 1);
+                block *tmp = new_block(h, t, cur);
+                h->nex = tmp;
+                t->pre = tmp;
+                return iterator(this, tmp, 1, cur, 1);
             }
-            node *cur = new node(pos.node_->pre, pos.node_);
-            cur->val = new T(value);
+            cur->own = pos.block_;
+            cur->pre = pos.node_->pre;
+            cur->nex = pos.node_;
             cur->pre->nex = cur;
             cur->nex->pre = cur;
             pos.node_ = cur;
@@ -776,19 +1080,23 @@ namespace sjtu {
                 node *tmp = pos.block_->bt->pre;
                 tmp->nex->pre = tmp->pre;
                 tmp->pre->nex = tmp->nex;
+                block *cur;
                 if (pos.block_->nex->siz == len || pos.block_->nex == t) {
                     ++num;
-                    block *cur = new block(pos.block_, pos.block_->nex, tmp);
+                    cur = new_block(pos.block_, pos.block_->nex, tmp);
                     cur->pre->nex = cur;
                     cur->nex->pre = cur;
                 } else {
-                    block *cur = pos.block_->nex;
+                    cur = pos.block_->nex;
                     ++cur->siz;
+                    tmp->own = cur;
                     tmp->pre = cur->bh;
                     tmp->nex = cur->bh->nex;
                     tmp->pre->nex = tmp;
                     tmp->nex->pre = tmp;
                 }
+                if (tmp == pos.node_)
+                    return iterator(this, cur, pos.num_ + 1, tmp, 1);
             } else {
                 ++pos.block_->siz;
             }
@@ -798,6 +1106,7 @@ namespace sjtu {
         iterator erase(iterator pos) {
             if (pos.deque_->siz == 0 || this != pos.deque_)
                 throw invalid_iterator();
+            cb = nullptr;
             --siz;
             if (pos.block_->siz == 1) {
                 --num;
@@ -814,7 +1123,7 @@ namespace sjtu {
                 }
                 tmp->pre->nex = tmp->nex;
                 tmp->nex->pre = tmp->pre;
-                delete tmp;
+                del_block(tmp);
                 return pos;
             }
             if (pos.block_->nex != t && pos.block_->siz + pos.block_->nex->siz <= len) {
@@ -822,6 +1131,8 @@ namespace sjtu {
                 block *tmp1 = pos.block_;
                 block *tmp2 = tmp1->nex;
                 tmp1->siz += tmp2->siz;
+                for (node *x = tmp2->bh->nex; x != tmp2->bt; x = x->nex)
+                    x->own = tmp1;
                 tmp1->bt->pre->nex = tmp2->bh->nex;
                 tmp2->bh->nex->pre = tmp1->bt->pre;
                 tmp1->bt->pre = tmp2->bt->pre;
@@ -830,13 +1141,13 @@ namespace sjtu {
                 tmp2->bt->pre = tmp2->bh;
                 tmp1->nex = tmp2->nex;
                 tmp2->nex->pre = tmp1;
-                delete tmp2;
+                del_block(tmp2);
             } else if (pos.pos_ == pos.block_->siz) {
                 node *tmp = pos.node_;
                 --pos.block_->siz;
                 tmp->pre->nex = tmp->nex;
                 tmp->nex->pre = tmp->pre;
-                delete tmp;
+                del_node(tmp);
                 if (pos.block_->nex == t) {
                     pos.node_ = pos.block_->bt;
                 } else {
@@ -852,22 +1163,67 @@ namespace sjtu {
             tmp->pre->nex = tmp->nex;
             tmp->nex->pre = tmp->pre;
             pos.node_ = tmp->nex;
-            delete tmp;
+            del_node(tmp);
             return pos;
         }
 
+        handle get_handle(const iterator &pos) const {
+            if (this != pos.deque_ || pos.node_ == nullptr || pos.node_->val == nullptr)
+                throw invalid_iterator();
+            return handle(this, pos.node_);
+        }
+
+        /**
+         * O(num) walk to find the block ordinal, plus at most len steps in the block.
+         */
+        iterator get_iterator(const handle &pos) {
+            if (pos.node_ == nullptr || this != pos.deque_)
+                throw invalid_iterator();
+            block *cur = pos.node_->own;
+            size_t n = 1;
+            for (block *tmp = h->nex; tmp != cur; tmp = tmp->nex)
+                ++n;
+            size_t p = 1;
+            for (node *tmp = cur->bh->nex; tmp != pos.node_; tmp = tmp->nex)
+                ++p;
+            return iterator(this, cur, n, pos.node_, p);
+        }
+
+        /**
+         * remove the element pos refers to in O(1); other handles stay valid.
+         */
+        void erase(handle pos) {
+            if (pos.node_ == nullptr || siz == 0 || this != pos.deque_)
+                throw invalid_iterator();
+            cb = nullptr;
+            node *tmp = pos.node_;
+            block *cur = tmp->own;
+            --siz;
+            if (--cur->siz == 0) {
+                --num;
+                cur->pre->nex = cur->nex;
+                cur->nex->pre = cur->pre;
+                del_block(cur);
+                return;
+            }
+            tmp->pre->nex = tmp->nex;
+            tmp->nex->pre = tmp->pre;
+            del_node(tmp);
+        }
+
         void push_back(const T &value) {
+            node *tmp = new_node(value);
             ++siz;
             if (t->pre != h && t->pre->siz < len) {
                 ++t->pre->siz;
-                node *tmp = new node(t->pre->bt->pre, t->pre->bt);
-                tmp->val = new T(value);
+                tmp->own = t->pre;
+                tmp->pre = t->pre->bt->pre;
+                tmp->nex = t->pre->bt;
                 tmp->pre->nex = tmp;
                 tmp->nex->pre = tmp;
             } else {
                 ++num;
-                node *tmp = new node(value);
-                block *cur = new block(t->pre, t, tmp);
+                block *cur = new_block(t->pre, t, tmp);
                 cur->pre->nex = cur;
                 cur->nex->pre = cur;
             }
@@ -876,34 +1232,37 @@ namespace sjtu {
         void pop_back() {
             if (siz == 0)
                 throw container_is_empty();
+            cb = nullptr;
             --siz;
             if (t->pre->siz > 1) {
                 --t->pre->siz;
                 node *tmp = t->pre->bt->pre;
                 tmp->pre->nex = tmp->nex;
                 tmp->nex->pre = tmp->pre;
-                delete tmp;
+                del_node(tmp);
             } else {
                 --num;
                 block *tmp = t->pre;
                 tmp->pre->nex = tmp->nex;
                 tmp->nex->pre = tmp->pre;
-                delete tmp;
+                del_block(tmp);
             }
         }
 
         void push_front(const T &value) {
+            cb = nullptr;
+            node *tmp = new_node(value);
             ++siz;
             if (h->nex != t && h->nex->siz < len) {
                 ++h->nex->siz;
-                node *tmp = new node(h->nex->bh, h->nex->bh->nex);
-                tmp->val = new T(value);
+                tmp->own = h->nex;
+                tmp->pre = h->nex->bh;
+                tmp->nex = h->nex->bh->nex;
                 tmp->pre->nex = tmp;
                 tmp->nex->pre = tmp;
             } else {
                 ++num;
-                node *tmp = new node(value);
-                block *cur = new block(h, h->nex, tmp);
+                block *cur = new_block(h, h->nex, tmp);
                 cur->pre->nex = cur;
                 cur->nex->pre = cur;
             }
@@ -912,23 +1271,177 @@ namespace sjtu {
         void pop_front() {
             if (siz == 0)
                 throw container_is_empty();
+            cb = nullptr;
             --siz;
             if (h->nex->siz > 1) {
                 --h->nex->siz;
                 node *tmp = h->nex->bh->nex;
                 tmp->pre->nex = tmp->nex;
                 tmp->nex->pre = tmp->pre;
-                delete tmp;
+                del_node(tmp);
             } else {
                 --num;
                 block *tmp = h->nex;
                 tmp->pre->nex = tmp->nex;
                 tmp->nex->pre = tmp->pre;
-                delete tmp;
+                del_block(tmp);
+            }
+        }
+
+        /**
+         * non-throwing pop_front()/pop_back(): copy the removed element into
+         * out and return true, or return false if the deque is empty.
+         * only copying T can throw, and then the deque is left unchanged.
+         */
+        bool try_pop_front(T &out) {
+            if (siz == 0)
+                return false;
+            out = *h->nex->bh->nex->val;
+            pop_front();
+            return true;
+        }
+
+        bool try_pop_back(T &out) {
+            if (siz == 0)
+                return false;
+            out = *t->pre->bt->pre->val;
+            pop_back();
+            return true;
+        }
+
+        /**
+         * append value[0], ..., value[n - 1] at the back.
+         */
+        void push_back_n(const T *value, size_t n) {
+            while (n > 0) {
+                node *tmp = new_node(*value);
+                block *cur = t->pre;
+                if (cur == h || cur->siz == len) {
+                    ++num;
+                    cur = new_block(t->pre, t, tmp);
+                    cur->pre->nex = cur;
+                    cur->nex->pre = cur;
+                } else {
+                    ++cur->siz;
+                    tmp->own = cur;
+                    tmp->pre = cur->bt->pre;
+                    tmp->nex = cur->bt;
+                    tmp->pre->nex = tmp;
+                    tmp->nex->pre = tmp;
+                }
+                ++siz;
+                ++value;
+                --n;
+                for (; n > 0 && cur->siz < len; --n, ++value) {
+                    tmp = new_node(*value);
+                    tmp->own = cur;
+                    tmp->pre = cur->bt->pre;
+                    tmp->nex = cur->bt;
+                    tmp->pre->nex = tmp;
+                    tmp->nex->pre = tmp;
+                    ++cur->siz;
+                    ++siz;
+                }
+            }
+        }
+
+        /**
+         * prepend value[0], ..., value[n - 1] so that value[0] becomes the front.
+         */
+        void push_front_n(const T *value, size_t n) {
+            cb = nullptr;
+            value += n;
+            while (n > 0) {
+                node *tmp = new_node(*--value);
+                block *cur = h->nex;
+                if (cur == t || cur->siz == len) {
+                    ++num;
+                    cur = new_block(h, h->nex, tmp);
+                    cur->pre->nex = cur;
+                    cur->nex->pre = cur;
+                } else {
+                    ++cur->siz;
+                    tmp->own = cur;
+                    tmp->pre = cur->bh;
+                    tmp->nex = cur->bh->nex;
+                    tmp->pre->nex = tmp;
+                    tmp->nex->pre = tmp;
+                }
+                ++siz;
+                --n;
+                for (; n > 0 && cur->siz < len; --n) {
+                    tmp = new_node(*--value);
+                    tmp->own = cur;
+                    tmp->pre = cur->bh;
+                    tmp->nex = cur->bh->nex;
+                    tmp->pre->nex = tmp;
+                    tmp->nex->pre = tmp;
+                    ++cur->siz;
+                    ++siz;
+                }
             }
         }
+
+        /**
+         * call f on each of the first n elements (fewer if the deque is shorter)
+         * and remove them, releasing a whole block at a time.
+         * returns the number of elements removed.
+         */
+        template<class F>
+        size_t drain_front(size_t n, F f) {
+            size_t cnt = 0;
+            while (cnt < n && siz > 0) {
+                block *cur = h->nex;
+                size_t k = n - cnt < cur->siz ? n - cnt : cur->siz;
+                node *tmp = cur->bh->nex;
+                const node *ahead = lead(tmp, cur->bt);
+                size_t i = 0;
+                try {
+                    for (; i < k; ++i, tmp = tmp->nex) {
+                        step(ahead, cur->bt);
+                        f(*tmp->val);
+                    }
+                } catch (...) {
+                    cut_front(cur, tmp, i);
+                    throw;
+                }
+                cut_front(cur, tmp, k);
+                cnt += k;
+            }
+            return cnt;
+        }
+
+        size_t pop_front_n(T *out, size_t n) {
+            return drain_front(n, [&out](T &v) { *out++ = v; });
+        }
+
+        /**
+         * remove up to n elements from the back; out[0] receives the old back.
+         */
+        size_t pop_back_n(T *out, size_t n) {
+            size_t cnt = 0;
+            while (cnt < n && siz > 0) {
+                block *cur = t->pre;
+                size_t k = n - cnt < cur->siz ? n - cnt : cur->siz;
+                node *tmp = cur->bt->pre;
+                size_t i = 0;
+                try {
+                    for (; i < k; ++i, tmp = tmp->pre)
+                        *out++ = *tmp->val;
+                } catch (...) {
+                    cut_back(cur, tmp, i);
+                    throw;
+                }
+                cut_back(cur, tmp, k);
+                cnt += k;
+            }
+            return cnt;
+        }
     };
 
+    template<class T, class Alloc>
+    unsigned deque<T, Alloc>::prefetch_distance = 8;
+
 }
 
 #endif
@@ -2,41 +2,44 @@
 #define SJTU_EXCEPTIONS_HPP
 
 #include <cstddef>
-#include <cstring>
-#include <string>
+#include <exception>
 
 namespace sjtu {
 
-class exception {
+/**
+ * the message is a string literal owned by the class, so constructing,
+ * copying and throwing an exception never allocates.
+ */
+class exception : public std::exception {
 protected:
-	const std::string variant = "";
-	std::string detail = "";
+	const char *variant = "";
 public:
-	exception() {}
-	exception(const exception &ec) : variant(ec.variant), detail(ec.detail) {}
-	virtual std::string what() {
-		return variant + " " + detail;
+	exception() noexcept {}
+	explicit exception(const char *v) noexcept : variant(v) {}
+	exception(const exception &ec) noexcept : variant(ec.variant) {}
+	const char *what() const noexcept override {
+		return variant;
 	}
 };
 
-/**
- * TODO
- * Please complete them.
- */
 class index_out_of_bound : public exception {
-	/* __________________________ */
+public:
+	index_out_of_bound() noexcept : exception("index_out_of_bound") {}
 };
 
 class runtime_error : public exception {
-	/* __________________________ */
+public:
+	runtime_error() noexcept : exception("runtime_error") {}
 };
 
 class invalid_iterator : public exception {
-	/* __________________________ */
+public:
+	invalid_iterator() noexcept : exception("invalid_iterator") {}
 };
 
 class container_is_empty : public exception {
-	/* __________________________ */
+public:
+	container_is_empty() noexcept : exception("container_is_empty") {}
 };
 }
 
@@ -0,0 +1,252 @@
+#ifndef SJTU_MINMAX_HEAP_HPP
+#define SJTU_MINMAX_HEAP_HPP
+
+#include "exceptions.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <utility>
+
+namespace sjtu {
+
+    /**
+     * a double-ended priority queue (min-max heap).
+     * even levels of the heap are ordered as a min-heap and odd levels as a
+     * max-heap, so both min() and max() are O(1) and push/pop_min/pop_max are
+     * O(log n). the array lives in fixed-size chunks, so growing only copies
+     * the chunk directory and never moves elements.
+     */
+    template<class T, class Compare = std::less<T> >
+    class minmax_heap {
+        static const size_t shift = 9;
+        static const size_t len = (size_t) 1 << shift;
+
+    private:
+        T **dir;
+        size_t dir_cap;
+        size_t chunks;
+        size_t siz;
+        Compare less;
+
+        T &get(size_t i) const {
+            return dir[i >> shift][i & (len - 1)];
+        }
+
+        static bool min_level(size_t i) {
+            size_t level = 0;
+            for (++i; i > 1; i >>= 1)
+                ++level;
+            return (level & 1) == 0;
+        }
+
+        void reserve_slot() {
+            if ((siz >> shift) < chunks)
+                return;
+            if (chunks == dir_cap) {
+                size_t cap = dir_cap == 0 ? 8 : dir_cap * 2;
+                T **tmp = new T *[cap];
+                for (size_t i = 0; i < chunks; ++i)
+                    tmp[i] = dir[i];
+                delete[] dir;
+                dir = tmp;
+                dir_cap = cap;
+            }
+            dir[chunks] = static_cast<T *>(::operator new(len * sizeof(T)));
+            ++chunks;
+        }
+
+        void shrink() {
+            while (chunks > (siz >> shift) + 2) {
+                --chunks;
+                ::operator delete(dir[chunks]);
+            }
+        }
+
+        void release() {
+            clear();
+            for (size_t i = 0; i < chunks; ++i)
+                ::operator delete(dir[i]);
+            delete[] dir;
+        }
+
+        void swap_at(size_t i, size_t j) {
+            using std::swap;
+            swap(get(i), get(j));
+        }
+
+        void bubble_up_min(size_t i) {
+            while (i > 2) {
+                size_t g = ((i - 1) / 2 - 1) / 2;
+                if (!less(get(i), get(g)))
+                    break;
+                swap_at(i, g);
+                i = g;
+            }
+        }
+
+        void bubble_up_max(size_t i) {
+            while (i > 2) {
+                size_t g = ((i - 1) / 2 - 1) / 2;
+                if (!less(get(g), get(i)))
+                    break;
+                swap_at(i, g);
+                i = g;
+            }
+        }
+
+        void bubble_up(size_t i) {
+            if (i == 0)
+                return;
+            size_t p = (i - 1) / 2;
+            if (min_level(i)) {
+                if (less(get(p), get(i))) {
+                    swap_at(i, p);
+                    bubble_up_max(p);
+                } else {
+                    bubble_up_min(i);
+                }
+            } else {
+                if (less(get(i), get(p))) {
+                    swap_at(i, p);
+                    bubble_up_min(p);
+                } else {
+                    bubble_up_max(i);
+                }
+            }
+        }
+
+        /**
+         * the best (smallest if is_min, else largest) child or grandchild of i.
+         */
+        size_t best_below(size_t i, bool is_min) const {
+            size_t m = 2 * i + 1;
+            size_t cand[6] = {2 * i + 1, 2 * i + 2, 4 * i + 3, 4 * i + 4, 4 * i + 5, 4 * i + 6};
+            for (size_t k = 1; k < 6 && cand[k] < siz; ++k) {
+                if (is_min ? less(get(cand[k]), get(m)) : less(get(m), get(cand[k])))
+                    m = cand[k];
+            }
+            return m;
+        }
+
+        void trickle_down(size_t i) {
+            bool is_min = min_level(i);
+            while (2 * i + 1 < siz) {
+                size_t m = best_below(i, is_min);
+                bool better = is_min ? less(get(m), get(i)) : less(get(i), get(m));
+                if (m <= 2 * i + 2) {
+                    if (better)
+                        swap_at(i, m);
+                    return;
+                }
+                if (!better)
+                    return;
+                swap_at(i, m);
+                size_t p = (m - 1) / 2;
+                if (is_min ? less(get(p), get(m)) : less(get(m), get(p)))
+                    swap_at(m, p);
+                i = m;
+            }
+        }
+
+        size_t max_index() const {
+            if (siz == 1)
+                return 0;
+            if (siz == 2)
+                return 1;
+            return less(get(1), get(2)) ? 2 : 1;
+        }
+
+        void remove(size_t i) {
+            if (i != siz - 1)
+                swap_at(i, siz - 1);
+            get(siz - 1).~T();
+            --siz;
+            if (i < siz)
+                trickle_down(i);
+            shrink();
+        }
+
+    public:
+        minmax_heap() : dir(nullptr), dir_cap(0), chunks(0), siz(0) {}
+
+        minmax_heap(const minmax_heap &other) : dir(nullptr), dir_cap(0), chunks(0), siz(0), less(other.less) {
+            try {
+                for (size_t i = 0; i < other.siz; ++i) {
+                    reserve_slot();
+                    new(&get(siz)) T(other.get(i));
+                    ++siz;
+                }
+            } catch (...) {
+                release();
+                throw;
+            }
+        }
+
+        ~minmax_heap() {
+            release();
+        }
+
+        minmax_heap &operator=(const minmax_heap &other) {
+            if (this == &other)
+                return *this;
+            clear();
+            less = other.less;
+            for (size_t i = 0; i < other.siz; ++i) {
+                reserve_slot();
+                new(&get(siz)) T(other.get(i));
+                ++siz;
+            }
+            return *this;
+        }
+
+        const T &min() const {
+            if (siz == 0)
+                throw container_is_empty();
+            return get(0);
+        }
+
+        const T &max() const {
+            if (siz == 0)
+                throw container_is_empty();
+            return get(max_index());
+        }
+
+        void push(const T &value) {
+            reserve_slot();
+            new(&get(siz)) T(value);
+            ++siz;
+            bubble_up(siz - 1);
+        }
+
+        void pop_min() {
+            if (siz == 0)
+                throw container_is_empty();
+            remove(0);
+        }
+
+        void pop_max() {
+            if (siz == 0)
+                throw container_is_empty();
+            remove(max_index());
+        }
+
+        bool empty() const {
+            return siz == 0;
+        }
+
+        size_t size() const {
+            return siz;
+        }
+
+        void clear() {
+            for (size_t i = 0; i < siz; ++i)
+                get(i).~T();
+            siz = 0;
+            shrink();
+        }
+    };
+
+}
+
+#endif
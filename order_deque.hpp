@@ -0,0 +1,377 @@
+#ifndef SJTU_ORDER_DEQUE_HPP
+#define SJTU_ORDER_DEQUE_HPP
+
+#include "exceptions.hpp"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu {
+
+    /**
+     * a growable deque with per-block summaries for range queries.
+     * elements live in one circular buffer cut into blocks of blen slots;
+     * a segment tree over the blocks keeps count/min/max/sum, so at() is
+     * O(1), lower_bound() on sorted data and range_min/max/sum over [i, j)
+     * are O(log n), and push/pop at both ends stay amortized O(1) + O(log n):
+     * a pop only rescans its block when it removes the block's min or max,
+     * and takes the value off the sum with operator- when T has one.
+     * T must be default constructible, ordered by operator< and support +.
+     */
+    template<class T>
+    class order_deque {
+        static const size_t blen = 64;
+
+        template<class U, class = void>
+        struct has_minus : std::false_type {};
+
+        template<class U>
+        struct has_minus<U, decltype((void) (std::declval<U>() - std::declval<U>()))> : std::true_type {};
+
+        struct summary {
+            size_t cnt;
+            T mn;
+            T mx;
+            T sum;
+
+            summary() : cnt(0), mn(), mx(), sum() {}
+
+            void add(const T &v) {
+                if (cnt == 0) {
+                    mn = mx = sum = v;
+                } else {
+                    if (v < mn) mn = v;
+                    if (mx < v) mx = v;
+                    sum = sum + v;
+                }
+                ++cnt;
+            }
+
+            /**
+             * take v out of the summary without rescanning the block; false if
+             * the block has to be rebuilt because v was its min or max (or the
+             * sum cannot be updated without operator-).
+             */
+            bool remove(const T &v) {
+                if (--cnt == 0) {
+                    *this = summary();
+                    return true;
+                }
+                if (!(mn < v) || !(v < mx))
+                    return false;
+                return sub(v, std::integral_constant<bool, has_minus<T>::value>());
+            }
+
+            bool sub(const T &v, std::true_type) {
+                sum = sum - v;
+                return true;
+            }
+
+            bool sub(const T &, std::false_type) {
+                return false;
+            }
+
+            void add(const summary &o) {
+                if (o.cnt == 0)
+                    return;
+                if (cnt == 0) {
+                    *this = o;
+                    return;
+                }
+                if (o.mn < mn) mn = o.mn;
+                if (mx < o.mx) mx = o.mx;
+                sum = sum + o.sum;
+                cnt += o.cnt;
+            }
+        };
+
+    private:
+        T *buf;
+        size_t mask;
+        size_t head;
+        size_t siz;
+        size_t nb;
+        summary *tree;
+
+        T *slot(size_t pos) const {
+            return buf + ((head + pos) & mask);
+        }
+
+        bool live(size_t phys) const {
+            return ((phys - head) & mask) < siz;
+        }
+
+        void pull(size_t b) {
+            for (b = (b + nb) >> 1; b > 0; b >>= 1) {
+                tree[b] = tree[b << 1];
+                tree[b].add(tree[b << 1 | 1]);
+            }
+        }
+
+        void rebuild_block(size_t b) {
+            summary s;
+            for (size_t p = b * blen; p < (b + 1) * blen; ++p)
+                if (live(p))
+                    s.add(buf[p]);
+            tree[b + nb] = s;
+            pull(b);
+        }
+
+        /**
+         * drop v, the element at physical slot p that is no longer live, from
+         * its block summary.
+         */
+        void unsummarize(size_t p, const T &v) {
+            size_t b = p / blen;
+            if (tree[b + nb].remove(v))
+                pull(b);
+            else
+                rebuild_block(b);
+        }
+
+        void reserve(size_t cap) {
+            summary *tr = new summary[2 * (cap / blen)];
+            T *tmp;
+            try {
+                tmp = static_cast<T *>(::operator new(cap * sizeof(T)));
+            } catch (...) {
+                delete[] tr;
+                throw;
+            }
+            size_t i = 0;
+            try {
+                for (; i < siz; ++i)
+                    new(tmp + i) T(*slot(i));
+            } catch (...) {
+                for (; i > 0; --i)
+                    tmp[i - 1].~T();
+                ::operator delete(tmp);
+                delete[] tr;
+                throw;
+            }
+            for (i = 0; i < siz; ++i)
+                slot(i)->~T();
+            ::operator delete(buf);
+            delete[] tree;
+            buf = tmp;
+            tree = tr;
+            mask = cap - 1;
+            head = 0;
+            nb = cap / blen;
+            for (i = 0; i < siz; ++i)
+                tree[i / blen + nb].add(buf[i]);
+            for (size_t b = nb - 1; b > 0; --b) {
+                tree[b] = tree[b << 1];
+                tree[b].add(tree[b << 1 | 1]);
+            }
+        }
+
+        summary query(size_t i, size_t j) const {
+            summary s;
+            if (i >= j)
+                return s;
+            size_t a = (head + i) & mask;
+            size_t b = (head + j - 1) & mask;
+            if (a > b) {
+                query_phys(a, mask + 1, s);
+                query_phys(0, b + 1, s);
+            } else {
+                query_phys(a, b + 1, s);
+            }
+            return s;
+        }
+
+        void query_phys(size_t a, size_t b, summary &s) const {
+            size_t l = (a + blen - 1) / blen;
+            size_t r = b / blen;
+            if (l >= r) {
+                for (size_t p = a; p < b; ++p)
+                    s.add(buf[p]);
+                return;
+            }
+            for (size_t p = a; p < l * blen; ++p)
+                s.add(buf[p]);
+            for (size_t p = r * blen; p < b; ++p)
+                s.add(buf[p]);
+            for (l += nb, r += nb; l < r; l >>= 1, r >>= 1) {
+                if (l & 1) s.add(tree[l++]);
+                if (r & 1) s.add(tree[--r]);
+            }
+        }
+
+    public:
+        order_deque() : mask(blen - 1), head(0), siz(0), nb(1) {
+            tree = new summary[2];
+            try {
+                buf = static_cast<T *>(::operator new(blen * sizeof(T)));
+            } catch (...) {
+                delete[] tree;
+                throw;
+            }
+        }
+
+        order_deque(const order_deque &other) : mask(other.mask), head(0), siz(0), nb(other.nb) {
+            tree = new summary[2 * nb];
+            try {
+                buf = static_cast<T *>(::operator new((mask + 1) * sizeof(T)));
+            } catch (...) {
+                delete[] tree;
+                throw;
+            }
+            try {
+                for (size_t i = 0; i < other.siz; ++i)
+                    push_back(*other.slot(i));
+            } catch (...) {
+                clear();
+                ::operator delete(buf);
+                delete[] tree;
+                throw;
+            }
+        }
+
+        ~order_deque() {
+            clear();
+            ::operator delete(buf);
+            delete[] tree;
+        }
+
+        order_deque &operator=(const order_deque &other) {
+            if (this == &other)
+                return *this;
+            clear();
+            for (size_t i = 0; i < other.siz; ++i)
+                push_back(*other.slot(i));
+            return *this;
+        }
+
+        const T &at(const size_t &pos) const {
+            if (pos >= siz)
+                throw index_out_of_bound();
+            return *slot(pos);
+        }
+
+        const T &operator[](const size_t &pos) const {
+            return at(pos);
+        }
+
+        /**
+         * element access is read-only so the block summaries stay valid;
+         * set() overwrites one element and refreshes its block.
+         */
+        void set(const size_t &pos, const T &value) {
+            if (pos >= siz)
+                throw index_out_of_bound();
+            size_t p = (head + pos) & mask;
+            buf[p] = value;
+            rebuild_block(p / blen);
+        }
+
+        const T &front() const {
+            if (siz == 0)
+                throw container_is_empty();
+            return *slot(0);
+        }
+
+        const T &back() const {
+            if (siz == 0)
+                throw container_is_empty();
+            return *slot(siz - 1);
+        }
+
+        bool empty() const {
+            return siz == 0;
+        }
+
+        size_t size() const {
+            return siz;
+        }
+
+        void clear() {
+            for (size_t i = 0; i < siz; ++i)
+                slot(i)->~T();
+            for (size_t b = 0; b < 2 * nb; ++b)
+                tree[b] = summary();
+            head = 0;
+            siz = 0;
+        }
+
+        /**
+         * index of the first element not less than key, or size() if none.
+         * the deque must be sorted in non-decreasing order.
+         */
+        size_t lower_bound(const T &key) const {
+            size_t l = 0, r = siz;
+            while (l < r) {
+                size_t m = l + (r - l) / 2;
+                if (*slot(m) < key)
+                    l = m + 1;
+                else
+                    r = m;
+            }
+            return l;
+        }
+
+        T range_sum(size_t i, size_t j) const {
+            if (i > j || j > siz)
+                throw index_out_of_bound();
+            return query(i, j).sum;
+        }
+
+        T range_min(size_t i, size_t j) const {
+            if (i >= j || j > siz)
+                throw index_out_of_bound();
+            return query(i, j).mn;
+        }
+
+        T range_max(size_t i, size_t j) const {
+            if (i >= j || j > siz)
+                throw index_out_of_bound();
+            return query(i, j).mx;
+        }
+
+        void push_back(const T &value) {
+            if (siz == mask + 1)
+                reserve(2 * (mask + 1));
+            size_t p = (head + siz) & mask;
+            new(buf + p) T(value);
+            ++siz;
+            tree[p / blen + nb].add(buf[p]);
+            pull(p / blen);
+        }
+
+        void push_front(const T &value) {
+            if (siz == mask + 1)
+                reserve(2 * (mask + 1));
+            size_t p = (head - 1) & mask;
+            new(buf + p) T(value);
+            head = p;
+            ++siz;
+            tree[p / blen + nb].add(buf[p]);
+            pull(p / blen);
+        }
+
+        void pop_back() {
+            if (siz == 0)
+                throw container_is_empty();
+            size_t p = (head + siz - 1) & mask;
+            --siz;
+            unsummarize(p, buf[p]);
+            buf[p].~T();
+        }
+
+        void pop_front() {
+            if (siz == 0)
+                throw container_is_empty();
+            size_t p = head;
+            head = (head + 1) & mask;
+            --siz;
+            unsummarize(p, buf[p]);
+            buf[p].~T();
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,421 @@
+#ifndef SJTU_RING_DEQUE_HPP
+#define SJTU_RING_DEQUE_HPP
+
+#include "exceptions.hpp"
+
+#include <cstddef>
+#include <new>
+
+namespace sjtu {
+
+    /**
+     * a bounded deque backed by one circular buffer.
+     * the capacity is rounded up to a power of two so that an index is
+     * mapped to a slot with a single mask; nothing is allocated after
+     * construction and pushing into a full deque throws runtime_error.
+     */
+    template<class T>
+    class ring_deque {
+    protected:
+        T *buf;
+        size_t mask;
+        size_t head;
+        size_t siz;
+        bool own;
+
+        static constexpr size_t round_up(size_t n) {
+            size_t cap = 1;
+            while (cap < n)
+                cap <<= 1;
+            return cap;
+        }
+
+        T *slot(size_t pos) const {
+            return buf + ((head + pos) & mask);
+        }
+
+        ring_deque(T *b, size_t cap) : buf(b), mask(cap - 1), head(0), siz(0), own(false) {}
+
+        void assign(const ring_deque &other) {
+            for (size_t i = 0; i < other.siz; ++i) {
+                new(buf + i) T(*other.slot(i));
+                siz = i + 1;
+            }
+        }
+
+    public:
+        class const_iterator;
+
+        class iterator {
+            friend class ring_deque;
+            friend class const_iterator;
+
+        private:
+            ring_deque *deque_;
+            size_t pos_;
+
+        public:
+            iterator() : deque_(nullptr), pos_(0) {}
+            iterator(ring_deque *d, size_t p) : deque_(d), pos_(p) {}
+
+            iterator operator+(const int &n) const {
+                iterator tmp(*this);
+                return tmp += n;
+            }
+            iterator operator-(const int &n) const {
+                iterator tmp(*this);
+                return tmp -= n;
+            }
+            int operator-(const iterator &rhs) const {
+                if (deque_ != rhs.deque_)
+                    throw invalid_iterator();
+                return (int) pos_ - (int) rhs.pos_;
+            }
+            iterator &operator+=(const int &n) {
+                long p = (long) pos_ + n;
+                if (p < 0 || p > (long) deque_->siz)
+                    throw invalid_iterator();
+                pos_ = p;
+                return *this;
+            }
+            iterator &operator-=(const int &n) {
+                return *this += -n;
+            }
+            iterator operator++(int) {
+                iterator tmp(*this);
+                ++*this;
+                return tmp;
+            }
+            iterator &operator++() {
+                if (pos_ == deque_->siz)
+                    throw invalid_iterator();
+                ++pos_;
+                return *this;
+            }
+            iterator operator--(int) {
+                iterator tmp(*this);
+                --*this;
+                return tmp;
+            }
+            iterator &operator--() {
+                if (pos_ == 0)
+                    throw invalid_iterator();
+                --pos_;
+                return *this;
+            }
+            T &operator*() const {
+                if (pos_ >= deque_->siz)
+                    throw invalid_iterator();
+                return *deque_->slot(pos_);
+            }
+            T *operator->() const {
+                return &**this;
+            }
+            bool operator==(const iterator &rhs) const {
+                return deque_ == rhs.deque_ && pos_ == rhs.pos_;
+            }
+            bool operator==(const const_iterator &rhs) const {
+                return deque_ == rhs.deque_ && pos_ == rhs.pos_;
+            }
+            bool operator!=(const iterator &rhs) const {
+                return !(*this == rhs);
+            }
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+        };
+
+        class const_iterator {
+            friend class ring_deque;
+            friend class iterator;
+
+        private:
+            const ring_deque *deque_;
+            size_t pos_;
+
+        public:
+            const_iterator() : deque_(nullptr), pos_(0) {}
+            const_iterator(const iterator &o) : deque_(o.deque_), pos_(o.pos_) {}
+            const_iterator(const ring_deque *d, size_t p) : deque_(d), pos_(p) {}
+
+            const_iterator operator+(const int &n) const {
+                const_iterator tmp(*this);
+                return tmp += n;
+            }
+            const_iterator operator-(const int &n) const {
+                const_iterator tmp(*this);
+                return tmp -= n;
+            }
+            int operator-(const const_iterator &rhs) const {
+                if (deque_ != rhs.deque_)
+                    throw invalid_iterator();
+                return (int) pos_ - (int) rhs.pos_;
+            }
+            const_iterator &operator+=(const int &n) {
+                long p = (long) pos_ + n;
+                if (p < 0 || p > (long) deque_->siz)
+                    throw invalid_iterator();
+                pos_ = p;
+                return *this;
+            }
+            const_iterator &operator-=(const int &n) {
+                return *this += -n;
+            }
+            const_iterator operator++(int) {
+                const_iterator tmp(*this);
+                ++*this;
+                return tmp;
+            }
+            const_iterator &operator++() {
+                if (pos_ == deque_->siz)
+                    throw invalid_iterator();
+                ++pos_;
+                return *this;
+            }
+            const_iterator operator--(int) {
+                const_iterator tmp(*this);
+                --*this;
+                return tmp;
+            }
+            const_iterator &operator--() {
+                if (pos_ == 0)
+                    throw invalid_iterator();
+                --pos_;
+                return *this;
+            }
+            const T &operator*() const {
+                if (pos_ >= deque_->siz)
+                    throw invalid_iterator();
+                return *deque_->slot(pos_);
+            }
+            const T *operator->() const {
+                return &**this;
+            }
+            bool operator==(const iterator &rhs) const {
+                return deque_ == rhs.deque_ && pos_ == rhs.pos_;
+            }
+            bool operator==(const const_iterator &rhs) const {
+                return deque_ == rhs.deque_ && pos_ == rhs.pos_;
+            }
+            bool operator!=(const iterator &rhs) const {
+                return !(*this == rhs);
+            }
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+        };
+
+        explicit ring_deque(size_t capacity) : mask(round_up(capacity) - 1), head(0), siz(0), own(true) {
+            buf = static_cast<T *>(::operator new((mask + 1) * sizeof(T)));
+        }
+
+        ring_deque(const ring_deque &other) : mask(other.mask), head(0), siz(0), own(true) {
+            buf = static_cast<T *>(::operator new((mask + 1) * sizeof(T)));
+            try {
+                assign(other);
+            } catch (...) {
+                clear();
+                ::operator delete(buf);
+                throw;
+            }
+        }
+
+        ~ring_deque() {
+            clear();
+            if (own)
+                ::operator delete(buf);
+        }
+
+        ring_deque &operator=(const ring_deque &other) {
+            if (this == &other)
+                return *this;
+            clear();
+            if (other.siz > mask + 1) {
+                if (!own)
+                    throw runtime_error();
+                T *tmp = static_cast<T *>(::operator new((other.mask + 1) * sizeof(T)));
+                ::operator delete(buf);
+                buf = tmp;
+                mask = other.mask;
+            }
+            head = 0;
+            assign(other);
+            return *this;
+        }
+
+        T &at(const size_t &pos) {
+            if (pos >= siz)
+                throw index_out_of_bound();
+            return *slot(pos);
+        }
+
+        const T &at(const size_t &pos) const {
+            if (pos >= siz)
+                throw index_out_of_bound();
+            return *slot(pos);
+        }
+
+        T &operator[](const size_t &pos) {
+            return at(pos);
+        }
+
+        const T &operator[](const size_t &pos) const {
+            return at(pos);
+        }
+
+        const T &front() const {
+            if (siz == 0)
+                throw container_is_empty();
+            return *slot(0);
+        }
+
+        const T &back() const {
+            if (siz == 0)
+                throw container_is_empty();
+            return *slot(siz - 1);
+        }
+
+        iterator begin() {
+            return iterator(this, 0);
+        }
+
+        const_iterator cbegin() const {
+            return const_iterator(this, 0);
+        }
+
+        iterator end() {
+            return iterator(this, siz);
+        }
+
+        const_iterator cend() const {
+            return const_iterator(this, siz);
+        }
+
+        bool empty() const {
+            return siz == 0;
+        }
+
+        bool full() const {
+            return siz == mask + 1;
+        }
+
+        size_t size() const {
+            return siz;
+        }
+
+        size_t capacity() const {
+            return mask + 1;
+        }
+
+        void clear() {
+            for (size_t i = 0; i < siz; ++i)
+                slot(i)->~T();
+            head = 0;
+            siz = 0;
+        }
+
+        iterator insert(iterator pos, const T &value) {
+            if (this != pos.deque_ || pos.pos_ > siz)
+                throw invalid_iterator();
+            if (full())
+                throw runtime_error();
+            size_t k = pos.pos_;
+            if (k == siz) {
+                push_back(value);
+                return iterator(this, k);
+            }
+            if (k == 0) {
+                push_front(value);
+                return iterator(this, 0);
+            }
+            if (k < siz / 2) {
+                new(buf + ((head - 1) & mask)) T(*slot(0));
+                head = (head - 1) & mask;
+                ++siz;
+                for (size_t i = 1; i < k; ++i)
+                    *slot(i) = *slot(i + 1);
+            } else {
+                new(slot(siz)) T(*slot(siz - 1));
+                ++siz;
+                for (size_t i = siz - 2; i > k; --i)
+                    *slot(i) = *slot(i - 1);
+            }
+            *slot(k) = value;
+            return iterator(this, k);
+        }
+
+        iterator erase(iterator pos) {
+            if (this != pos.deque_ || pos.pos_ >= siz)
+                throw invalid_iterator();
+            size_t k = pos.pos_;
+            if (k < siz / 2) {
+                for (size_t i = k; i > 0; --i)
+                    *slot(i) = *slot(i - 1);
+                pop_front();
+            } else {
+                for (size_t i = k; i + 1 < siz; ++i)
+                    *slot(i) = *slot(i + 1);
+                pop_back();
+            }
+            return iterator(this, k);
+        }
+
+        void push_back(const T &value) {
+            if (full())
+                throw runtime_error();
+            new(slot(siz)) T(value);
+            ++siz;
+        }
+
+        void pop_back() {
+            if (siz == 0)
+                throw container_is_empty();
+            slot(--siz)->~T();
+        }
+
+        void push_front(const T &value) {
+            if (full())
+                throw runtime_error();
+            new(buf + ((head - 1) & mask)) T(value);
+            head = (head - 1) & mask;
+            ++siz;
+        }
+
+        void pop_front() {
+            if (siz == 0)
+                throw container_is_empty();
+            slot(0)->~T();
+            head = (head + 1) & mask;
+            --siz;
+        }
+    };
+
+    /**
+     * ring_deque whose buffer lives inside the object itself.
+     */
+    template<class T, size_t N>
+    class fixed_deque : public ring_deque<T> {
+        static const size_t cap = N <= 1 ? 1 : ring_deque<T>::round_up(N);
+
+        alignas(T) unsigned char storage[cap * sizeof(T)];
+
+    public:
+        fixed_deque() : ring_deque<T>(reinterpret_cast<T *>(storage), cap) {}
+
+        fixed_deque(const fixed_deque &other) : ring_deque<T>(reinterpret_cast<T *>(storage), cap) {
+            this->assign(other);
+        }
+
+        ~fixed_deque() {
+            this->clear();
+        }
+
+        fixed_deque &operator=(const fixed_deque &other) {
+            ring_deque<T>::operator=(other);
+            return *this;
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,329 @@
+#ifndef SJTU_SPILL_DEQUE_HPP
+#define SJTU_SPILL_DEQUE_HPP
+
+#include "exceptions.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <new>
+#include <type_traits>
+
+#if !defined(_WIN32)
+#include <sys/types.h>
+#endif
+
+namespace sjtu {
+
+    /**
+     * a deque that keeps at most `budget` blocks in memory.
+     * the front and back blocks are always resident; cold blocks in the
+     * middle are written to a temporary file (least recently used first)
+     * and read back when they are accessed again.
+     * references returned by at() are only valid until the next access.
+     */
+    template<class T>
+    class spill_deque {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "spill_deque only stores trivially copyable types");
+
+        static const size_t len = 4096;
+
+        class block {
+            friend class spill_deque;
+
+            size_t beg;
+            size_t siz;
+            block *pre;
+            block *nex;
+            T *val;
+            long slot;
+            block *lru_pre;
+            block *lru_nex;
+
+            block(size_t b) : beg(b), siz(0), pre(nullptr), nex(nullptr), val(nullptr),
+                              slot(-1), lru_pre(nullptr), lru_nex(nullptr) {}
+        };
+
+    private:
+        size_t siz;
+        size_t num;
+        size_t budget;
+        size_t resident;
+        block *h;
+        block *t;
+        block *lru_h;
+        block *lru_t;
+        std::FILE *file;
+        long slots;
+        long *free_slot;
+        size_t free_cnt;
+        size_t free_cap;
+
+        void lru_unlink(block *b) {
+            if (b->lru_pre != nullptr) b->lru_pre->lru_nex = b->lru_nex;
+            else lru_h = b->lru_nex;
+            if (b->lru_nex != nullptr) b->lru_nex->lru_pre = b->lru_pre;
+            else lru_t = b->lru_pre;
+            b->lru_pre = b->lru_nex = nullptr;
+        }
+
+        void lru_push(block *b) {
+            b->lru_pre = nullptr;
+            b->lru_nex = lru_h;
+            if (lru_h != nullptr) lru_h->lru_pre = b;
+            else lru_t = b;
+            lru_h = b;
+        }
+
+        long take_slot() {
+            if (free_cnt > 0)
+                return free_slot[--free_cnt];
+            return slots++;
+        }
+
+        void give_slot(long s) {
+            if (s < 0)
+                return;
+            if (free_cnt == free_cap) {
+                size_t cap = free_cap == 0 ? 16 : free_cap * 2;
+                long *tmp = new long[cap];
+                for (size_t i = 0; i < free_cnt; ++i)
+                    tmp[i] = free_slot[i];
+                delete[] free_slot;
+                free_slot = tmp;
+                free_cap = cap;
+            }
+            free_slot[free_cnt++] = s;
+        }
+
+        /**
+         * offsets are 64-bit even where long is 32-bit, so the spill file can
+         * grow past 2 GiB.
+         */
+        void seek(const block *b) {
+            long long off = ((long long) b->slot * (long long) len + (long long) b->beg) * (long long) sizeof(T);
+#if defined(_WIN32)
+            if (_fseeki64(file, off, SEEK_SET) != 0)
+                throw runtime_error();
+#else
+            if (fseeko(file, (off_t) off, SEEK_SET) != 0)
+                throw runtime_error();
+#endif
+        }
+
+        void evict(block *b) {
+            if (file == nullptr) {
+                file = std::tmpfile();
+                if (file == nullptr)
+                    throw runtime_error();
+            }
+            if (b->slot < 0)
+                b->slot = take_slot();
+            seek(b);
+            if (std::fwrite(b->val + b->beg, sizeof(T), b->siz, file) != b->siz)
+                throw runtime_error();
+            ::operator delete(b->val);
+            b->val = nullptr;
+            lru_unlink(b);
+            --resident;
+        }
+
+        void make_room() {
+            block *cur = lru_t;
+            while (resident >= budget && cur != nullptr) {
+                block *tmp = cur->lru_pre;
+                if (cur != h->nex && cur != t->pre)
+                    evict(cur);
+                cur = tmp;
+            }
+        }
+
+        void load(block *b) {
+            if (b->val != nullptr) {
+                if (b != lru_h) {
+                    lru_unlink(b);
+                    lru_push(b);
+                }
+                return;
+            }
+            make_room();
+            b->val = static_cast<T *>(::operator new(len * sizeof(T)));
+            lru_push(b);
+            ++resident;
+            if (b->slot < 0 || b->siz == 0)
+                return;
+            seek(b);
+            if (std::fread(b->val + b->beg, sizeof(T), b->siz, file) != b->siz)
+                throw runtime_error();
+        }
+
+        void drop(block *b) {
+            b->pre->nex = b->nex;
+            b->nex->pre = b->pre;
+            if (b->val != nullptr) {
+                lru_unlink(b);
+                --resident;
+                ::operator delete(b->val);
+            }
+            give_slot(b->slot);
+            --num;
+            delete b;
+        }
+
+        block *locate(size_t &pos) const {
+            block *cur;
+            if (pos < siz / 2) {
+                cur = h->nex;
+                while (pos >= cur->siz) {
+                    pos -= cur->siz;
+                    cur = cur->nex;
+                }
+            } else {
+                size_t rest = siz - pos;
+                cur = t->pre;
+                while (rest > cur->siz) {
+                    rest -= cur->siz;
+                    cur = cur->pre;
+                }
+                pos = cur->siz - rest;
+            }
+            return cur;
+        }
+
+    public:
+        explicit spill_deque(size_t budget_ = 64) : siz(0), num(0), budget(budget_ < 3 ? 3 : budget_),
+                                                   resident(0), lru_h(nullptr), lru_t(nullptr), file(nullptr),
+                                                   slots(0), free_slot(nullptr), free_cnt(0), free_cap(0) {
+            h = new block(0);
+            t = new block(0);
+            h->nex = t;
+            t->pre = h;
+        }
+
+        spill_deque(const spill_deque &other) = delete;
+        spill_deque &operator=(const spill_deque &other) = delete;
+
+        ~spill_deque() {
+            clear();
+            delete h;
+            delete t;
+            delete[] free_slot;
+            if (file != nullptr)
+                std::fclose(file);
+        }
+
+        void set_budget(size_t budget_) {
+            budget = budget_ < 3 ? 3 : budget_;
+            make_room();
+        }
+
+        size_t get_budget() const {
+            return budget;
+        }
+
+        size_t resident_blocks() const {
+            return resident;
+        }
+
+        T &at(const size_t &pos) {
+            if (pos >= siz)
+                throw index_out_of_bound();
+            size_t p = pos;
+            block *cur = locate(p);
+            load(cur);
+            return cur->val[cur->beg + p];
+        }
+
+        T &operator[](const size_t &pos) {
+            return at(pos);
+        }
+
+        const T &front() const {
+            if (siz == 0)
+                throw container_is_empty();
+            return h->nex->val[h->nex->beg];
+        }
+
+        const T &back() const {
+            if (siz == 0)
+                throw container_is_empty();
+            return t->pre->val[t->pre->beg + t->pre->siz - 1];
+        }
+
+        bool empty() const {
+            return siz == 0;
+        }
+
+        size_t size() const {
+            return siz;
+        }
+
+        void clear() {
+            while (h->nex != t)
+                drop(h->nex);
+            free_cnt = 0;
+            slots = 0;
+            siz = 0;
+        }
+
+        void push_back(const T &value) {
+            block *cur = t->pre;
+            if (cur == h || cur->beg + cur->siz == len) {
+                cur = new block(0);
+                cur->pre = t->pre;
+                cur->nex = t;
+                t->pre->nex = cur;
+                t->pre = cur;
+                ++num;
+                load(cur);
+            }
+            new(cur->val + cur->beg + cur->siz) T(value);
+            ++cur->siz;
+            ++siz;
+        }
+
+        void push_front(const T &value) {
+            block *cur = h->nex;
+            if (cur == t || cur->beg == 0) {
+                cur = new block(len);
+                cur->pre = h;
+                cur->nex = h->nex;
+                h->nex->pre = cur;
+                h->nex = cur;
+                ++num;
+                load(cur);
+            }
+            new(cur->val + cur->beg - 1) T(value);
+            --cur->beg;
+            ++cur->siz;
+            ++siz;
+        }
+
+        void pop_back() {
+            if (siz == 0)
+                throw container_is_empty();
+            --siz;
+            if (--t->pre->siz == 0) {
+                drop(t->pre);
+                if (t->pre != h)
+                    load(t->pre);
+            }
+        }
+
+        void pop_front() {
+            if (siz == 0)
+                throw container_is_empty();
+            --siz;
+            block *cur = h->nex;
+            ++cur->beg;
+            if (--cur->siz == 0) {
+                drop(cur);
+                if (h->nex != t)
+                    load(h->nex);
+            }
+        }
+    };
+
+}
+
+#endif
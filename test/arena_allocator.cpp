@@ -0,0 +1,64 @@
+#include "deque.hpp"
+#include "check.hpp"
+
+#include <cstdint>
+#include <thread>
+
+struct alignas(64) line {
+    long v;
+
+    line(long x = 0) : v(x) {}
+};
+
+struct alignas(128) page {
+    long v;
+    char pad[5000];
+
+    page(long x = 0) : v(x) {}
+};
+
+template<class T>
+void aligned(size_t n) {
+    typedef sjtu::deque<T, sjtu::arena_allocator> deque;
+    deque d;
+    for (long i = 0; i < (long) n; ++i) {
+        d.push_back(T(i));
+        d.push_front(T(-i));
+    }
+    for (typename deque::iterator x = d.begin(); x != d.end(); ++x)
+        CHECK(reinterpret_cast<uintptr_t>(&*x) % alignof(T) == 0);
+    std::thread th([&d] { d.clear(); });
+    th.join();
+    for (long i = 0; i < (long) n; ++i)
+        d.push_back(T(i));
+    long i = 0;
+    for (typename deque::iterator x = d.begin(); x != d.end(); ++x, ++i) {
+        CHECK(reinterpret_cast<uintptr_t>(&*x) % alignof(T) == 0);
+        CHECK(x->v == i);
+    }
+}
+
+int main() {
+    aligned<line>(5000);
+    aligned<page>(500);
+
+    // objects freed by another thread come back to this one
+    typedef sjtu::deque<long, sjtu::arena_allocator> deque;
+    for (int r = 0; r < 20; ++r) {
+        deque *d = new deque;
+        for (long i = 0; i < 50000; ++i)
+            d->push_back(i);
+        std::thread th([d] { delete d; });
+        th.join();
+    }
+
+    void *p = sjtu::arena_allocator::allocate(0);
+    void *q = sjtu::arena_allocator::allocate(0);
+    CHECK(p != nullptr && q != nullptr && p != q);
+    sjtu::arena_allocator::deallocate(p, 0);
+    sjtu::arena_allocator::deallocate(q, 0);
+    void *big = sjtu::arena_allocator::allocate(100000);
+    CHECK(reinterpret_cast<uintptr_t>(big) % 16 == 0);
+    sjtu::arena_allocator::deallocate(big, 100000);
+    return 0;
+}
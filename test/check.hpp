@@ -0,0 +1,32 @@
+#ifndef SJTU_TEST_CHECK_HPP
+#define SJTU_TEST_CHECK_HPP
+
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * abort the test with the failing expression and its location.
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            std::exit(1); \
+        } \
+    } while (0)
+
+/**
+ * CHECK that expr throws an exception of type E.
+ */
+#define CHECK_THROWS(expr, E) \
+    do { \
+        bool thrown = false; \
+        try { \
+            expr; \
+        } catch (const E &) { \
+            thrown = true; \
+        } \
+        CHECK(thrown && #expr " throws " #E); \
+    } while (0)
+
+#endif
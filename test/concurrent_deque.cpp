@@ -0,0 +1,79 @@
+#include "concurrent_deque.hpp"
+#include "check.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <thread>
+
+int main() {
+    sjtu::concurrent_deque<long> d;
+    std::deque<long> s;
+    std::srand(6);
+    for (int it = 0; it < 200000; ++it) {
+        int op = std::rand() % 4;
+        long v = std::rand();
+        if (op == 0) {
+            d.push_back(v);
+            s.push_back(v);
+        } else if (op == 1) {
+            d.push_front(v);
+            s.push_front(v);
+        } else if (op == 2 && !s.empty()) {
+            d.pop_front();
+            s.pop_front();
+        } else if (op == 3 && !s.empty()) {
+            d.pop_back();
+            s.pop_back();
+        }
+        CHECK(d.size() == s.size());
+        if (!s.empty())
+            CHECK(d.front() == s.front() && d.back() == s.back());
+    }
+    size_t i = 0;
+    d.for_each([&](const long &v) {
+        CHECK(v == s[i]);
+        ++i;
+    });
+    CHECK(i == s.size());
+    while (!d.empty())
+        d.pop_back();
+    CHECK_THROWS(d.pop_front(), sjtu::container_is_empty);
+    CHECK_THROWS(d.front(), sjtu::container_is_empty);
+
+    // front keys only ever shrink and back keys only ever grow, so every
+    // scan must see a strictly increasing sequence whatever the writer does.
+    sjtu::concurrent_deque<long> q;
+    std::atomic<bool> done(false), ok(true);
+    std::thread readers[3];
+    for (int t = 0; t < 3; ++t)
+        readers[t] = std::thread([&] {
+            while (!done.load()) {
+                bool first = true;
+                long last = 0;
+                q.for_each([&](const long &v) {
+                    if (!first && !(last < v))
+                        ok.store(false);
+                    first = false;
+                    last = v;
+                });
+            }
+        });
+    long lo = 0, hi = 0;
+    for (int it = 0; it < 2000000; ++it) {
+        int op = std::rand() % 4;
+        if (op == 0)
+            q.push_back(++hi);
+        else if (op == 1)
+            q.push_front(lo--);
+        else if (op == 2 && !q.empty())
+            q.pop_front();
+        else if (op == 3 && !q.empty())
+            q.pop_back();
+    }
+    done.store(true);
+    for (int t = 0; t < 3; ++t)
+        readers[t].join();
+    CHECK(ok.load());
+    return 0;
+}
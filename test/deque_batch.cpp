@@ -0,0 +1,72 @@
+#include "deque.hpp"
+#include "check.hpp"
+
+#include <cstdlib>
+#include <deque>
+#include <string>
+
+int main() {
+    sjtu::deque<std::string> d;
+    std::deque<std::string> s;
+    static std::string buf[3000], out[3000];
+    std::srand(5);
+    for (int it = 0; it < 4000; ++it) {
+        int op = std::rand() % 6;
+        size_t n = std::rand() % (std::rand() % 2 ? 3000 : 20);
+        for (size_t i = 0; i < n; ++i)
+            buf[i] = std::to_string(std::rand());
+        size_t expect = n < s.size() ? n : s.size();
+        if (op == 0) {
+            d.push_back_n(buf, n);
+            s.insert(s.end(), buf, buf + n);
+        } else if (op == 1) {
+            d.push_front_n(buf, n);
+            s.insert(s.begin(), buf, buf + n);
+        } else if (op == 2) {
+            CHECK(d.pop_front_n(out, n) == expect);
+            for (size_t i = 0; i < expect; ++i) {
+                CHECK(out[i] == s.front());
+                s.pop_front();
+            }
+        } else if (op == 3) {
+            CHECK(d.pop_back_n(out, n) == expect);
+            for (size_t i = 0; i < expect; ++i) {
+                CHECK(out[i] == s.back());
+                s.pop_back();
+            }
+        } else if (op == 4) {
+            size_t c = 0;
+            CHECK(d.drain_front(n, [&](std::string &v) {
+                CHECK(v == s[c]);
+                ++c;
+            }) == expect);
+            CHECK(c == expect);
+            s.erase(s.begin(), s.begin() + expect);
+        } else {
+            d.push_back("a");
+            s.push_back("a");
+            d.push_front("b");
+            s.push_front("b");
+        }
+        CHECK(d.size() == s.size());
+        size_t i = 0;
+        for (sjtu::deque<std::string>::iterator x = d.begin(); x != d.end(); ++x, ++i)
+            CHECK(*x == s[i]);
+    }
+
+    d.clear();
+    for (int i = 0; i < 2000; ++i)
+        d.push_back(std::to_string(i));
+    int c = 0;
+    try {
+        d.drain_front(1500, [&c](std::string &) {
+            if (++c == 700)
+                throw 1;
+        });
+        CHECK(false);
+    } catch (int) {
+    }
+    CHECK(d.size() == 1301);
+    CHECK(d.front() == "699");
+    return 0;
+}
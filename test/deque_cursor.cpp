@@ -0,0 +1,55 @@
+#include "deque.hpp"
+#include "check.hpp"
+
+#include <cstdlib>
+#include <deque>
+#include <thread>
+
+int main() {
+    sjtu::deque<long> d;
+    std::deque<long> s;
+    std::srand(3);
+    for (long i = 0; i < 5000; ++i) {
+        d.push_back(i);
+        s.push_back(i);
+    }
+    for (int it = 0; it < 300; ++it) {
+        size_t k = std::rand() % (s.size() + 1);
+        long v = std::rand();
+        d.insert(d.begin() + (int) k, v);
+        s.insert(s.begin() + k, v);
+        k = std::rand() % s.size();
+        d.erase(d.begin() + (int) k);
+        s.erase(s.begin() + k);
+
+        sjtu::deque<long>::cursor c = d.get_cursor();
+        size_t step = 1 + std::rand() % 40;
+        for (size_t i = 0; i < s.size(); i += step)
+            CHECK(c[i] == s[i]);
+        for (size_t i = s.size(); i-- > 0;)
+            CHECK(c.at(i) == s[i]);
+        for (int j = 0; j < 50; ++j) {
+            size_t i = std::rand() % s.size();
+            CHECK(d[i] == s[i]);
+            d[i] = v + j;
+            s[i] = v + j;
+        }
+        CHECK_THROWS(c.at(s.size()), sjtu::index_out_of_bound);
+    }
+
+    const sjtu::deque<long> &cd = d;
+    bool ok[4] = {true, true, true, true};
+    std::thread th[4];
+    for (int t = 0; t < 4; ++t)
+        th[t] = std::thread([&cd, &s, &ok, t] {
+            for (size_t i = t; i < s.size(); i += 3)
+                if (cd[i] != s[i] || *cd.try_at(i) != s[i])
+                    ok[t] = false;
+        });
+    for (int t = 0; t < 4; ++t) {
+        th[t].join();
+        CHECK(ok[t]);
+    }
+    CHECK(cd.try_at(s.size()) == nullptr);
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "deque.hpp"
+#include "check.hpp"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+int main() {
+    typedef sjtu::deque<std::string> deque;
+    deque d;
+    for (int i = 0; i < 3000; ++i)
+        d.push_back(std::to_string(i));
+    std::vector<deque::handle> hs;
+    std::vector<std::string> vs;
+    for (int i = 0; i < 3000; i += 37) {
+        hs.push_back(d.get_handle(d.begin() + i));
+        vs.push_back(std::to_string(i));
+    }
+
+    std::srand(4);
+    for (int it = 0; it < 2000; ++it) {
+        size_t k = std::rand() % (d.size() + 1);
+        d.insert(d.begin() + (int) k, "x");
+        d.push_front("f");
+        d.push_back("b");
+        for (int j = 0; j < 2; ++j) {
+            size_t e = std::rand() % d.size();
+            if (d[e][0] == 'x' || d[e][0] == 'f' || d[e][0] == 'b')
+                d.erase(d.begin() + (int) e);
+        }
+    }
+    for (size_t i = 0; i < hs.size(); ++i) {
+        CHECK(*hs[i] == vs[i]);
+        CHECK(hs[i]->size() == vs[i].size());
+        deque::iterator x = d.get_iterator(hs[i]);
+        CHECK(*x == vs[i]);
+        CHECK(d.get_handle(x) == hs[i]);
+    }
+
+    size_t before = d.size();
+    for (size_t i = 0; i < hs.size(); i += 2)
+        d.erase(hs[i]);
+    CHECK(d.size() == before - (hs.size() + 1) / 2);
+    for (size_t i = 1; i < hs.size(); i += 2)
+        CHECK(*d.get_iterator(hs[i]) == vs[i]);
+
+    deque other;
+    other.push_back("o");
+    deque::handle foreign = other.get_handle(other.begin());
+    CHECK_THROWS(d.get_iterator(foreign), sjtu::invalid_iterator);
+    CHECK_THROWS(d.erase(foreign), sjtu::invalid_iterator);
+    CHECK_THROWS(d.get_handle(other.begin()), sjtu::invalid_iterator);
+    CHECK_THROWS(d.get_handle(d.end()), sjtu::invalid_iterator);
+    CHECK_THROWS(*deque::handle(), sjtu::invalid_iterator);
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "deque.hpp"
+#include "check.hpp"
+
+#include <string>
+
+struct counting_allocator {
+    static size_t count;
+
+    static void *allocate(size_t n) {
+        ++count;
+        return ::operator new(n);
+    }
+
+    static void deallocate(void *p, size_t) noexcept {
+        ::operator delete(p);
+    }
+};
+
+size_t counting_allocator::count = 0;
+
+int main() {
+    typedef sjtu::deque<int, counting_allocator> small;
+    for (int k = 0; k < 1000; ++k) {
+        small q;
+        for (int j = 0; j < 16; ++j)
+            q.push_back(j);
+        q.pop_front();
+        q.push_front(-1);
+        small e(q);
+        CHECK(e.size() == 16 && e.front() == -1 && e.back() == 15);
+    }
+    CHECK(counting_allocator::count == 0);
+
+    small q;
+    for (int j = 0; j < 100; ++j)
+        q.push_back(j);
+    CHECK(counting_allocator::count > 0);
+    for (int j = 0; j < 100; ++j)
+        CHECK(q[j] == j);
+    q.clear();
+    size_t before = counting_allocator::count;
+    for (int j = 0; j < 10; ++j)
+        q.push_front(j);
+    CHECK(counting_allocator::count == before);
+
+    sjtu::deque<std::string> s;
+    for (int j = 0; j < 2000; ++j) {
+        s.push_back(std::to_string(j));
+        if (j % 7 == 0)
+            s.pop_front();
+    }
+    sjtu::deque<std::string> t;
+    t = s;
+    CHECK(t.size() == s.size());
+    CHECK(t.front() == s.front() && t.back() == s.back());
+    return 0;
+}
@@ -0,0 +1,44 @@
+#include "deque.hpp"
+#include "check.hpp"
+
+#include <cstring>
+#include <string>
+
+int main() {
+    sjtu::deque<std::string> d;
+    std::string out = "untouched";
+    CHECK(!d.try_pop_front(out) && !d.try_pop_back(out));
+    CHECK(out == "untouched");
+    CHECK(d.try_at(0) == nullptr);
+    for (int i = 0; i < 1000; ++i)
+        d.push_back(std::to_string(i));
+    CHECK(d.try_at(1000) == nullptr);
+    CHECK(*d.try_at(999) == "999");
+    CHECK(d.try_pop_front(out) && out == "0");
+    CHECK(d.try_pop_back(out) && out == "999");
+    CHECK(d.size() == 998);
+    const sjtu::deque<std::string> &cd = d;
+    CHECK(*cd.try_at(0) == "1" && cd.try_at(998) == nullptr);
+    while (d.try_pop_back(out))
+        ;
+    CHECK(d.empty() && out == "1");
+
+    try {
+        d.at(0);
+        CHECK(false);
+    } catch (const sjtu::exception &e) {
+        CHECK(std::strcmp(e.what(), "index_out_of_bound") == 0);
+    }
+    try {
+        d.pop_front();
+        CHECK(false);
+    } catch (const std::exception &e) {
+        CHECK(std::strcmp(e.what(), "container_is_empty") == 0);
+    }
+    CHECK_THROWS(d.end()->size(), sjtu::invalid_iterator);
+    CHECK(std::strcmp(sjtu::runtime_error().what(), "runtime_error") == 0);
+    CHECK(std::strcmp(sjtu::invalid_iterator().what(), "invalid_iterator") == 0);
+    sjtu::exception copy(sjtu::container_is_empty{});
+    CHECK(std::strcmp(copy.what(), "container_is_empty") == 0);
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "minmax_heap.hpp"
+#include "check.hpp"
+
+#include <cstdlib>
+#include <functional>
+#include <set>
+#include <string>
+
+template<class Compare>
+void random_ops(unsigned seed) {
+    sjtu::minmax_heap<std::string, Compare> h;
+    std::multiset<std::string, Compare> s;
+    std::srand(seed);
+    for (int it = 0; it < 200000; ++it) {
+        int op = std::rand() % 5;
+        if (op < 2) {
+            std::string v = std::to_string(std::rand() % 5000);
+            h.push(v);
+            s.insert(v);
+        } else if (op == 2 && !s.empty()) {
+            h.pop_min();
+            s.erase(s.begin());
+        } else if (op == 3 && !s.empty()) {
+            h.pop_max();
+            s.erase(--s.end());
+        } else if (it % 50000 == 0) {
+            sjtu::minmax_heap<std::string, Compare> c(h), a;
+            a.push("x");
+            a = c;
+            h = a;
+        }
+        CHECK(h.size() == s.size());
+        if (!s.empty())
+            CHECK(h.min() == *s.begin() && h.max() == *--s.end());
+    }
+    while (!s.empty()) {
+        CHECK(h.max() == *--s.end());
+        h.pop_max();
+        s.erase(--s.end());
+    }
+    CHECK(h.empty());
+}
+
+int main() {
+    random_ops<std::less<std::string> >(9);
+    random_ops<std::greater<std::string> >(10);
+
+    sjtu::minmax_heap<long> h;
+    for (long i = 0; i < 100000; ++i)
+        h.push((i * 7919) % 100000);
+    for (long i = 0; i < 50000; ++i) {
+        CHECK(h.min() == i && h.max() == 99999 - i);
+        h.pop_min();
+        h.pop_max();
+    }
+    CHECK(h.empty());
+    CHECK_THROWS(h.min(), sjtu::container_is_empty);
+    CHECK_THROWS(h.max(), sjtu::container_is_empty);
+    CHECK_THROWS(h.pop_min(), sjtu::container_is_empty);
+    CHECK_THROWS(h.pop_max(), sjtu::container_is_empty);
+    h.push(1);
+    h.clear();
+    CHECK(h.empty());
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include "order_deque.hpp"
+#include "check.hpp"
+
+#include <cstdlib>
+#include <deque>
+
+/**
+ * a value with + and < but no -, so pops fall back to rebuilding the block.
+ */
+struct plain {
+    long v;
+
+    plain() : v(0) {}
+    plain(long x) : v(x) {}
+
+    plain operator+(const plain &o) const {
+        return plain(v + o.v);
+    }
+    bool operator<(const plain &o) const {
+        return v < o.v;
+    }
+    bool operator!=(const plain &o) const {
+        return v != o.v;
+    }
+};
+
+template<class T>
+void random_ops(unsigned seed) {
+    sjtu::order_deque<T> d;
+    std::deque<long> s;
+    std::srand(seed);
+    for (int it = 0; it < 200000; ++it) {
+        int op = std::rand() % 7;
+        long v = std::rand() % 1000 - 500;
+        if (op == 0) {
+            d.push_back(T(v));
+            s.push_back(v);
+        } else if (op == 1) {
+            d.push_front(T(v));
+            s.push_front(v);
+        } else if (op == 2 && !s.empty()) {
+            d.pop_front();
+            s.pop_front();
+        } else if (op == 3 && !s.empty()) {
+            d.pop_back();
+            s.pop_back();
+        } else if (op == 4 && !s.empty()) {
+            size_t i = std::rand() % s.size();
+            d.set(i, T(v));
+            s[i] = v;
+        } else if (!s.empty()) {
+            size_t i = std::rand() % s.size();
+            size_t j = i + 1 + std::rand() % (s.size() - i);
+            long sum = 0, mn = s[i], mx = s[i];
+            for (size_t k = i; k < j; ++k) {
+                sum += s[k];
+                mn = s[k] < mn ? s[k] : mn;
+                mx = mx < s[k] ? s[k] : mx;
+            }
+            CHECK(!(d.range_sum(i, j) != T(sum)));
+            CHECK(!(d.range_min(i, j) != T(mn)));
+            CHECK(!(d.range_max(i, j) != T(mx)));
+            CHECK(!(d.at(i) != T(s[i])));
+        }
+        CHECK(d.size() == s.size());
+        if (it == 100000) {
+            sjtu::order_deque<T> e(d);
+            d = e;
+        }
+    }
+}
+
+int main() {
+    random_ops<long>(7);
+    random_ops<plain>(8);
+
+    sjtu::order_deque<long> o;
+    for (long i = 0; i < 200; ++i)
+        o.push_back(i);
+    o.set(100, 100000);
+    CHECK(o.range_max(0, 200) == 100000);
+    CHECK(o.range_max(0, 100) == 99);
+    o.set(100, -5);
+    CHECK(o.range_min(50, 150) == -5);
+
+    sjtu::order_deque<long> m;
+    for (long i = 0; i < 100000; ++i)
+        m.push_back(i * 2);
+    for (long key = -3; key < 200010; key += 997) {
+        size_t e = key <= 0 ? 0 : (size_t) (key + 1) / 2;
+        CHECK(m.lower_bound(key) == (e > 100000 ? 100000 : e));
+    }
+    CHECK_THROWS(m.range_min(5, 5), sjtu::index_out_of_bound);
+    CHECK_THROWS(m.set(100000, 1), sjtu::index_out_of_bound);
+    m.clear();
+    CHECK_THROWS(m.pop_back(), sjtu::container_is_empty);
+    return 0;
+}
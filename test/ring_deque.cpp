@@ -0,0 +1,109 @@
+#include "ring_deque.hpp"
+#include "check.hpp"
+
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <string>
+
+static size_t allocations = 0;
+
+void *operator new(size_t n) {
+    ++allocations;
+    void *p = std::malloc(n == 0 ? 1 : n);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+
+template<class D>
+void random_ops(D &d) {
+    std::deque<std::string> s;
+    std::srand(2);
+    for (int it = 0; it < 200000; ++it) {
+        int op = std::rand() % 9;
+        std::string v = std::to_string(std::rand());
+        try {
+            if (op == 0) {
+                d.push_back(v);
+                s.push_back(v);
+            } else if (op == 1) {
+                d.push_front(v);
+                s.push_front(v);
+            } else if (op == 2 && !s.empty()) {
+                d.pop_front();
+                s.pop_front();
+            } else if (op == 3 && !s.empty()) {
+                d.pop_back();
+                s.pop_back();
+            } else if (op == 4) {
+                size_t k = std::rand() % (s.size() + 1);
+                d.insert(d.begin() + (int) k, v);
+                s.insert(s.begin() + k, v);
+            } else if (op == 5 && !s.empty()) {
+                size_t k = std::rand() % s.size();
+                d.erase(d.begin() + (int) k);
+                s.erase(s.begin() + k);
+            } else if (!s.empty()) {
+                size_t i = std::rand() % s.size();
+                CHECK(d.at(i) == s[i]);
+            }
+        } catch (const sjtu::runtime_error &) {
+            CHECK(d.full());
+        }
+        CHECK(d.size() == s.size());
+    }
+    size_t i = 0;
+    for (typename D::const_iterator x = d.cbegin(); x != d.cend(); ++x, ++i)
+        CHECK(*x == s[i]);
+    D e(d);
+    i = 0;
+    for (typename D::iterator x = e.begin(); x != e.end(); ++x, ++i)
+        CHECK(*x == s[i]);
+}
+
+int main() {
+    sjtu::ring_deque<std::string> a(100);
+    CHECK(a.capacity() == 128);
+    random_ops(a);
+    sjtu::fixed_deque<std::string, 37> b;
+    CHECK(b.capacity() == 64);
+    random_ops(b);
+
+    sjtu::ring_deque<std::string> c(1);
+    c = a;
+    CHECK(c.size() == a.size() && c.capacity() == a.capacity());
+    for (size_t i = 0; i < a.size(); ++i)
+        CHECK(c[i] == a[i]);
+    sjtu::fixed_deque<std::string, 2> small;
+    sjtu::ring_deque<std::string> &small_ref = small;
+    sjtu::ring_deque<std::string> five(8);
+    for (int i = 0; i < 5; ++i)
+        five.push_back("x");
+    CHECK_THROWS(small_ref = five, sjtu::runtime_error);
+    CHECK(small.empty());
+
+    sjtu::ring_deque<long> r(1000);
+    size_t before = allocations;
+    for (long i = 0; i < 100000; ++i) {
+        if (r.full())
+            r.pop_front();
+        r.push_back(i);
+        if (i % 3 == 0)
+            r.pop_back();
+    }
+    CHECK(allocations == before);
+    CHECK_THROWS(r.at(r.size()), sjtu::index_out_of_bound);
+    r.clear();
+    CHECK_THROWS(r.pop_front(), sjtu::container_is_empty);
+    CHECK_THROWS(*r.begin(), sjtu::invalid_iterator);
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include "spill_deque.hpp"
+#include "check.hpp"
+
+#include <cstdlib>
+#include <deque>
+
+int main() {
+    sjtu::spill_deque<long> d(4);
+    std::deque<long> s;
+    std::srand(1);
+    for (int it = 0; it < 300000; ++it) {
+        int op = std::rand() % 7;
+        long v = std::rand();
+        if (op < 2) {
+            d.push_back(v);
+            s.push_back(v);
+        } else if (op < 4) {
+            d.push_front(v);
+            s.push_front(v);
+        } else if (op == 4 && !s.empty()) {
+            d.pop_front();
+            s.pop_front();
+        } else if (op == 5 && !s.empty()) {
+            d.pop_back();
+            s.pop_back();
+        } else if (!s.empty()) {
+            size_t i = std::rand() % s.size();
+            CHECK(d.at(i) == s[i]);
+        }
+        CHECK(d.size() == s.size());
+        CHECK(d.resident_blocks() <= d.get_budget());
+        if (!s.empty()) {
+            CHECK(d.front() == s.front());
+            CHECK(d.back() == s.back());
+        }
+    }
+    for (size_t i = 0; i < s.size(); ++i)
+        CHECK(d[i] == s[i]);
+
+    d.set_budget(3);
+    CHECK(d.resident_blocks() <= 3);
+    for (size_t i = s.size(); i > 0; --i)
+        CHECK(d[i - 1] == s[i - 1]);
+
+    CHECK_THROWS(d.at(s.size()), sjtu::index_out_of_bound);
+    d.clear();
+    CHECK(d.empty());
+    CHECK_THROWS(d.pop_front(), sjtu::container_is_empty);
+    CHECK_THROWS(d.back(), sjtu::container_is_empty);
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "window_aggregator.hpp"
+#include "check.hpp"
+
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <string>
+
+struct concat {
+    std::string operator()(const std::string &a, const std::string &b) const {
+        return a + b;
+    }
+};
+
+int main() {
+    sjtu::window_extremum<long> mx;
+    sjtu::window_extremum<long, std::greater<long> > mn;
+    sjtu::window_aggregator<long, std::plus<long> > sum;
+    sjtu::window_aggregator<std::string, concat> cat;
+    std::deque<long> s;
+    std::srand(11);
+    for (int it = 0; it < 200000; ++it) {
+        if (std::rand() % 2 || s.empty()) {
+            long v = std::rand() % 1000;
+            mx.push(v);
+            mn.push(v);
+            sum.push(v);
+            cat.push(std::to_string(v % 10));
+            s.push_back(v);
+        } else {
+            mx.pop();
+            mn.pop();
+            sum.pop();
+            cat.pop();
+            s.pop_front();
+        }
+        CHECK(mx.size() == s.size() && sum.size() == s.size());
+        if (s.empty() || it % 97 != 0)
+            continue;
+        long a = s[0], b = s[0], c = 0;
+        std::string d;
+        for (size_t i = 0; i < s.size(); ++i) {
+            a = s[i] > a ? s[i] : a;
+            b = s[i] < b ? s[i] : b;
+            c += s[i];
+            d += std::to_string(s[i] % 10);
+        }
+        CHECK(mx.query() == a && mn.query() == b);
+        CHECK(sum.query() == c && cat.query() == d);
+        CHECK(sum.front() == s.front() && sum.back() == s.back());
+    }
+
+    mx.clear();
+    sum.clear();
+    CHECK(mx.empty() && sum.empty());
+    CHECK_THROWS(mx.query(), sjtu::container_is_empty);
+    CHECK_THROWS(mx.pop(), sjtu::container_is_empty);
+    CHECK_THROWS(sum.query(), sjtu::container_is_empty);
+    CHECK_THROWS(sum.pop(), sjtu::container_is_empty);
+    return 0;
+}
@@ -0,0 +1,146 @@
+#ifndef SJTU_WINDOW_AGGREGATOR_HPP
+#define SJTU_WINDOW_AGGREGATOR_HPP
+
+#include "deque.hpp"
+#include "exceptions.hpp"
+#include "utility.hpp"
+
+#include <cstddef>
+#include <functional>
+
+namespace sjtu {
+
+    /**
+     * sliding-window extremum over a FIFO of samples (monotonic deque).
+     * query() returns the greatest sample under Compare currently in the
+     * window: the maximum with std::less, the minimum with std::greater.
+     * push/pop are amortized O(1) and query() is O(1).
+     */
+    template<class T, class Compare = std::less<T> >
+    class window_extremum {
+    private:
+        deque<pair<T, size_t> > mono;
+        size_t head;
+        size_t tail;
+        Compare less;
+
+    public:
+        window_extremum(const Compare &cmp = Compare()) : head(0), tail(0), less(cmp) {}
+
+        void push(const T &value) {
+            while (!mono.empty() && less(mono.back().first, value))
+                mono.pop_back();
+            mono.push_back(pair<T, size_t>(value, tail));
+            ++tail;
+        }
+
+        void pop() {
+            if (head == tail)
+                throw container_is_empty();
+            if (mono.front().second == head)
+                mono.pop_front();
+            ++head;
+        }
+
+        const T &query() const {
+            if (head == tail)
+                throw container_is_empty();
+            return mono.front().first;
+        }
+
+        bool empty() const {
+            return head == tail;
+        }
+
+        size_t size() const {
+            return tail - head;
+        }
+
+        void clear() {
+            mono.clear();
+            head = tail = 0;
+        }
+    };
+
+    /**
+     * sliding-window fold with any associative Op (two-stack scheme).
+     * the window is split into a front part, for which agg keeps suffix
+     * aggregates, and a back part folded into back_agg. when the front part
+     * runs out it is rebuilt from the back part in one pass, so push/pop are
+     * amortized O(1), query() is O(1) and Op need not be invertible.
+     * T must be default constructible.
+     */
+    template<class T, class Op>
+    class window_aggregator {
+    private:
+        deque<T> vals;
+        deque<T> agg;
+        T back_agg;
+        Op op;
+
+        void flip() {
+            typename deque<T>::iterator it = vals.end();
+            for (size_t i = 0; i < vals.size(); ++i) {
+                --it;
+                if (i == 0)
+                    agg.push_front(*it);
+                else
+                    agg.push_front(op(*it, agg.front()));
+            }
+        }
+
+    public:
+        window_aggregator(const Op &op_ = Op()) : back_agg(), op(op_) {}
+
+        void push(const T &value) {
+            vals.push_back(value);
+            if (vals.size() == agg.size() + 1)
+                back_agg = value;
+            else
+                back_agg = op(back_agg, value);
+        }
+
+        void pop() {
+            if (vals.empty())
+                throw container_is_empty();
+            if (agg.empty())
+                flip();
+            agg.pop_front();
+            vals.pop_front();
+        }
+
+        T query() const {
+            if (vals.empty())
+                throw container_is_empty();
+            if (agg.empty())
+                return back_agg;
+            if (vals.size() == agg.size())
+                return agg.front();
+            return op(agg.front(), back_agg);
+        }
+
+        const T &front() const {
+            return vals.front();
+        }
+
+        const T &back() const {
+            return vals.back();
+        }
+
+        bool empty() const {
+            return vals.empty();
+        }
+
+        size_t size() const {
+            return vals.size();
+        }
+
+        void clear() {
+            vals.clear();
+            agg.clear();
+        }
+    };
+
+}
+
+#endif